@@ -0,0 +1,110 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <learnopengl/asset_manager.h>
+#include <learnopengl/gl_handle.h>
+#include <learnopengl/model.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// One asynchronously loaded asset. Only touched on the GL thread: asset stays null until the upload
+// is done, so callers draw a placeholder while !ready().
+template <class Handle>
+struct AssetRequest {
+    std::string path;
+    Handle asset;
+    bool failed = false;  // a texture that failed to decode is still ready, as the 1x1 white fallback
+    float importMillis = 0.0f;  // Assimp / mesh cache, worker thread
+    float decodeMillis = 0.0f;  // stb_image, worker thread
+    float uploadMillis = 0.0f;  // GL thread, summed over the frames the upload was spread across
+    float totalMillis = 0.0f;   // request to ready
+
+    bool ready() const { return asset != nullptr; }
+};
+
+// Loads models and textures in the background.
+// Worker threads run the GL-free half of every load (Model::import, decodeImage); finished jobs queue up
+// and update() uploads them on the GL thread within a per-frame time budget, textures through a
+// pixel unpack buffer. Uploaded assets are registered with the AssetManager, so they are shared with
+// synchronous loads as usual.
+class AssetLoader {
+public:
+    using ModelRequest = AssetRequest<AssetManager::ModelHandle>;
+    using TextureRequest = AssetRequest<AssetManager::TextureHandle>;
+
+    // threads = 0 uses one less than the hardware threads (at least one)
+    explicit AssetLoader(AssetManager& assets, unsigned int threads = 0);
+    // jobs still queued are dropped, running ones are finished first
+    ~AssetLoader();
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    // Never block. Assets the manager already holds come back ready, repeated requests share one job.
+    std::shared_ptr<const ModelRequest> requestModel(const std::string& path, ModelLoadOptions options = ModelLoadOptions());
+    std::shared_ptr<const TextureRequest> requestTexture(const std::string& path, const std::string& directory);
+
+    // GL thread, once per frame: uploads finished jobs until budgetMillis is spent. At least one step is
+    // taken per call, so a single large texture cannot stall loading forever.
+    void update(float budgetMillis);
+
+    unsigned int requested() const { return requestCount; }
+    unsigned int completed() const { return completeCount; }
+    float progress() const { return requestCount ? (float)completeCount / requestCount : 1.0f; }
+    bool idle() const { return completeCount == requestCount; }
+
+private:
+    struct Image {
+        std::string file;
+        std::uint64_t contentHash = 0;
+        DecodedImage pixels;
+    };
+
+    struct Job {
+        std::shared_ptr<ModelRequest> model;      // exactly one of model / texture is set
+        std::shared_ptr<TextureRequest> texture;
+        std::string key;                           // in-flight map entry
+        std::string path;                          // model path or full texture path
+        ModelLoadOptions options;
+        std::uint64_t contentHash = 0;
+        ModelData data;
+        std::vector<Image> images;
+        std::size_t uploaded = 0;                               // images already on the GPU
+        std::size_t failedImages = 0;                           // replaced by the fallback texture
+        std::vector<AssetManager::TextureHandle> textures;      // keeps them registered until the model holds them
+        std::chrono::steady_clock::time_point start;
+        float importMillis = 0.0f, decodeMillis = 0.0f, uploadMillis = 0.0f;
+    };
+
+    AssetManager& assets;
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::unique_ptr<Job>> pending;   // waiting for a worker
+    std::deque<std::unique_ptr<Job>> finished;  // waiting for the GL thread
+    bool stopping = false;
+
+    // GL thread only
+    std::unique_ptr<Job> uploading;
+    std::unordered_map<std::string, std::shared_ptr<ModelRequest>> modelsInFlight;
+    std::unordered_map<std::string, std::shared_ptr<TextureRequest>> texturesInFlight;
+    GLBuffer unpackBuffer;
+    unsigned int requestCount = 0, completeCount = 0;
+    std::chrono::steady_clock::time_point firstRequest;
+
+    void submit(std::unique_ptr<Job> job);
+    void workerLoop();
+    static void process(Job& job);
+    void uploadImage(Job& job, Image& image);
+    void finish(Job& job);
+};
+
+#endif
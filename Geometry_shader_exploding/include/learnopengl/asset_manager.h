@@ -0,0 +1,62 @@
+#ifndef ASSET_MANAGER_H
+#define ASSET_MANAGER_H
+
+#include <learnopengl/gl_handle.h>
+#include <learnopengl/model.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// Central registry of GPU assets.
+// Lookups go by canonical path first and by content hash second, so the same file reached through
+// different paths (or copied under another name) is still uploaded once. The registry only keeps
+// weak references: an asset is unloaded as soon as the last handle to it is dropped.
+class AssetManager {
+public:
+    using ModelHandle   = std::shared_ptr<Model>;
+    using MeshHandle    = std::shared_ptr<const DrawRange>;
+    using TextureHandle = std::shared_ptr<GLTexture>;
+
+    ModelHandle loadModel(const std::string& path, ModelLoadOptions options = ModelLoadOptions());
+    // decoded with TextureFromFile(path, directory)
+    TextureHandle loadTexture(const std::string& path, const std::string& directory);
+    // sub-mesh index of model; keeps the owning model alive for as long as the handle exists
+    static MeshHandle meshOf(const ModelHandle& model, std::size_t index);
+
+    // forgets registry entries whose assets were already unloaded
+    void collect();
+
+    struct Stats {
+        unsigned int modelRequests = 0, modelLoads = 0;
+        unsigned int textureRequests = 0, textureLoads = 0;
+    };
+    const Stats& stats() const { return counters; }
+
+private:
+    std::unordered_map<std::string, std::weak_ptr<Model>> modelsByPath;
+    std::unordered_map<std::string, std::weak_ptr<Model>> modelsByContent;
+    std::unordered_map<std::string, std::weak_ptr<GLTexture>> texturesByPath;
+    std::unordered_map<std::uint64_t, std::weak_ptr<GLTexture>> texturesByContent;
+    std::weak_ptr<GLTexture> fallback;
+    Stats counters;
+
+    // uploads done elsewhere (see AssetLoader) register through these
+    friend class AssetLoader;
+    // registry key of a model loaded from path with options
+    static std::string modelKey(const std::string& path, const ModelLoadOptions& options);
+    // by path, then by content when contentHash is not 0; neither counts as a request
+    ModelHandle lookupModel(const std::string& path, const ModelLoadOptions& options, std::uint64_t contentHash);
+    TextureHandle lookupTexture(const std::string& file, std::uint64_t contentHash);
+    ModelHandle addModel(const std::string& path, const ModelLoadOptions& options, std::uint64_t contentHash, Model model);
+    // file is directory + '/' + path of loadTexture
+    TextureHandle addTexture(const std::string& file, std::uint64_t contentHash, GLTexture texture);
+    // registers the shared 1x1 white fallback under file, so a file that failed to decode is never retried
+    TextureHandle addFailedTexture(const std::string& file);
+};
+
+// absolute, normalized form of path (falls back to path itself if it does not exist)
+std::string canonicalPath(const std::string& path);
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef CULLING_H
+#define CULLING_H
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// spheres tested per SIMD step
+const std::size_t CULLING_LANES = 4;
+
+struct BoundingSphere {
+    glm::vec3 center;
+    float radius;
+};
+
+// Planes of a view frustum as (normal, distance), normals pointing inwards and normalized,
+// so dot(normal, p) + distance is the signed distance of p from the plane.
+struct Frustum {
+    glm::vec4 planes[6];  // left, right, bottom, top, near, far
+};
+
+// Gribb / Hartmann plane extraction from a projection * view matrix (world-space planes)
+Frustum extractFrustum(const glm::mat4& viewProjection);
+
+// sphere around a transformed sphere; the radius grows by the largest axis scale of transform
+BoundingSphere transformSphere(const BoundingSphere& sphere, const glm::mat4& transform);
+
+struct CullingStats {
+    std::size_t visible = 0;
+    std::size_t culled = 0;
+};
+
+// World-space bounds of every instance drawn in a frame, stored as structure of arrays and tested
+// against the frustum CULLING_LANES at a time before any draw is issued.
+class CullingBatch {
+public:
+    void clear();
+    // returns the index to ask visible() about after cull()
+    std::size_t add(const BoundingSphere& sphere);
+    void cull(const Frustum& frustum);
+
+    bool visible(std::size_t i) const { return visibleFlags[i] != 0; }
+    std::size_t size() const { return x.size(); }
+    const CullingStats& stats() const { return stats_; }
+
+private:
+    std::vector<float> x, y, z, radius;
+    std::vector<std::uint8_t> visibleFlags;
+    CullingStats stats_;
+};
+
+// name of the instruction set used by CullingBatch::cull
+const char* cullingSimdName();
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef DEBRIS_H
+#define DEBRIS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <learnopengl/gl_handle.h>
+#include <learnopengl/shader.h>
+
+#include <cstddef>
+#include <vector>
+
+// one corner of a captured triangle, as transform feedback writes it (tightly packed, see debris.cpp)
+struct DebrisVertex {
+    glm::vec3 center;     // face centroid, world space; the three corners of a face move together
+    glm::vec3 corner;     // this corner relative to center
+    glm::vec3 nextCorner; // the face's following corner relative to center; the three sum to zero
+    glm::vec3 velocity;
+    glm::vec3 spin;       // rotation axis scaled by radians per second
+    glm::vec2 texCoords;
+    glm::vec4 tint;
+    float     rest;       // seconds spent at rest on the floor; the face sleeps past a threshold
+};
+static_assert(sizeof(DebrisVertex) == 88, "DebrisVertex mirrors the transform feedback output");
+
+// simulation of a wreck stops for good this long after its capture; every face has come to rest by then
+const float DEBRIS_SETTLE_SECONDS = 8.0f;
+
+// Persistent wreck fields that never return to the CPU.
+// A detonating instance's explodable copy is captured with transform feedback into a ring of debris
+// vertices; a second transform feedback pass integrates gravity, floor bounces and sleep, ping-ponging
+// between two buffers. Wrecks are ranges of the ring: a new wreck recycles the oldest wrecks it overlaps,
+// and settled wrecks are copied into both buffers once and never simulated again. The still-settling
+// wrecks are moved in one pass per contiguous run of them, usually one or two.
+class DebrisField {
+public:
+    // The ring holds ringWrecks wrecks the size of the first one reserved; its buffers are allocated
+    // then, and again for a larger wreck while the ring is empty. Debris comes to rest on y = floorY.
+    DebrisField(std::size_t ringWrecks, float floorY, const char* captureShaderPath, const char* updateShaderPath);
+    ~DebrisField();
+    DebrisField(const DebrisField&) = delete;
+    DebrisField& operator=(const DebrisField&) = delete;
+
+    // Claims the ring range of one wreck of vertexCount vertices, to be captured later this frame.
+    // False, and counted in dropped(), when the wreck is larger than the ring or would recycle a wreck
+    // reserved since the last update(); the caller explodes that instance some other way.
+    bool reserveWreck(std::size_t vertexCount);
+    // Starts capturing the oldest reserved wreck; false when none is left. Between begin and end the
+    // caller draws the explodable copy of its instance (ExplodeVertex attributes plus instance
+    // attributes) with captureShader(); rasterization is off.
+    bool beginCapture();
+    void endCapture();
+    Shader& captureShader() { return captureProgram; }
+
+    // moves the wrecks that are still settling; reserved wrecks that were never captured are forgotten
+    void update(float dt);
+    // every live wreck as GL_TRIANGLES, one multi-draw; the caller binds a program reading
+    // location 0 (center), 1 (corner), 5 (texture coordinates) and 6 (tint)
+    void draw() const;
+    void clear();
+
+    GLuint vertexArray() const { return vao[cur]; }
+    bool empty() const { return wrecks.empty(); }
+    // in vertices, 0 until the first wreck is reserved
+    std::size_t capacity() const { return capacity_; }
+    std::size_t wreckCount() const { return wrecks.size(); }
+    std::size_t settling() const;
+    std::size_t liveVertices() const;
+    std::size_t captured() const { return capturedCount; }
+    std::size_t recycled() const { return recycledCount; }
+    std::size_t dropped() const { return droppedCount; }
+    // feedback passes per update() that had wrecks to move
+    double passesPerUpdate() const { return updateCount ? (double)passCount / updateCount : 0.0; }
+
+private:
+    struct Wreck {
+        std::size_t first, count;  // vertices in the ring
+        float age;
+        bool captured;             // false from reserveWreck until its capture
+        bool settled;              // identical in both buffers, no longer simulated
+    };
+    struct Run {
+        std::size_t first, count;  // vertices moved by one feedback pass
+    };
+
+    Shader captureProgram, updateProgram;
+    UniformHandle updateDeltaTime;
+    GLBuffer vbo[2];
+    GLVertexArray vao[2];
+    int cur = 0;
+    std::size_t ringWrecks, capacity_ = 0, cursor = 0;
+    std::vector<Wreck> wrecks;  // oldest first
+    std::vector<GLint> drawFirst;
+    std::vector<GLsizei> drawCount;
+    std::vector<const Wreck*> ringOrder;
+    std::vector<Run> runs;
+    std::size_t capturedCount = 0, recycledCount = 0, droppedCount = 0;
+    std::size_t updateCount = 0, passCount = 0;
+
+    void allocate(std::size_t vertices);
+    void rebuildDrawList();
+};
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef DESTRUCTION_H
+#define DESTRUCTION_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <learnopengl/material.h>
+
+#include <cstdint>
+#include <vector>
+
+// Baked destruction: rigid fragments of a model are simulated once at import (launch, tumble, gravity,
+// floor bounces, settling) and the per-frame fragment transforms are stored in a float texture.
+// shader/destruction.vs plays a bake back with four texel fetches per vertex (two frames), so any number of wrecks
+// cost no CPU time. The last frame holds the settled wreck.
+const float DESTRUCTION_BAKE_FPS = 30.0f;
+const int DESTRUCTION_BAKE_FRAMES = 120;
+const int DESTRUCTION_SUBSTEPS = 8;  // simulation steps per baked frame
+// unit the baked frames are bound to, right after the material units
+const GLuint DESTRUCTION_TEXTURE_UNIT = MATERIAL_TEXTURE_UNITS;
+
+// rigid piece of a model, in object space
+struct DestructionFragment {
+    glm::vec3 center;
+    float radius;  // farthest vertex from center
+    float mass;    // surface area
+};
+
+// Row f holds frame f: texel 2i is fragment i's rotation (quaternion xyzw), texel 2i + 1 its translation
+// (xyz, w = 1); a rest-pose vertex p of the fragment moves to rotate(q, p) + t.
+struct DestructionBake {
+    int fragmentCount = 0;
+    int frameCount = 0;
+    float fps = DESTRUCTION_BAKE_FPS;
+    float reach = 0.0f;  // farthest any fragment gets from the bake's origin, radius included
+    std::vector<glm::vec4> texels;
+
+    bool empty() const { return fragmentCount == 0; }
+    float duration() const { return frameCount > 1 ? (frameCount - 1) / fps : 0.0f; }
+};
+
+// Fragments fly away from origin, fall under gravity and come to rest on the plane y = floorY.
+// Deterministic for a given seed. Touches no GL state, so it may run on a worker thread.
+DestructionBake bakeDestruction(const std::vector<DestructionFragment>& fragments, const glm::vec3& origin, float floorY,
+                                std::uint32_t seed = 1);
+
+// RGBA32F texture of bake.texels, nearest filtering (read with texelFetch)
+GLuint DestructionTextureFromBake(const DestructionBake& bake);
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef EXPLODE_MESH_H
+#define EXPLODE_MESH_H
+
+#include <learnopengl/mesh.h>
+
+#include <cstddef>
+#include <vector>
+
+// One corner of a de-indexed triangle for the vertex-shader explosion (shader/explode.vs). Every corner
+// carries its face's normal, centroid and seed, which the geometry shader path derives per frame.
+// Attribute locations: 0 position, 1 face normal, 2 texture coordinates, 3 face centroid, 4 seed,
+// 5 fragment (shader/destruction.vs), 6 next corner (shader/debris_capture.vs).
+struct ExplodeVertex {
+    glm::vec3 position;
+    glm::vec3 faceNormal;    // object space, unit length (zero for degenerate faces)
+    glm::vec2 texCoords;
+    glm::vec3 faceCentroid;  // object space
+    float     seed;          // per face in [0, 1), varies speed and spin between faces
+    float     fragment;      // rigid piece of the baked destruction the face belongs to (exact integer)
+    glm::vec3 nextCorner;    // object space position of the face's following corner, for debris floor contact
+};
+static_assert(sizeof(ExplodeVertex) == 64, "ExplodeVertex is uploaded as is");
+
+// three ExplodeVertex per triangle of indices, appended to out
+void buildExplodeVertices(const Vertex* vertices, const unsigned int* indices, std::size_t indexCount,
+                          std::vector<ExplodeVertex>& out);
+
+// attribute pointers of the bound VAO into the bound GL_ARRAY_BUFFER of ExplodeVertex
+void setExplodeVertexAttributes();
+
+#endif
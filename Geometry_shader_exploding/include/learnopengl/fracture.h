@@ -0,0 +1,57 @@
+#ifndef FRACTURE_H
+#define FRACTURE_H
+
+#include <learnopengl/destruction.h>
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Pre-fracture: a model's triangles are partitioned into spatially coherent rigid chunks once at import,
+// so an explosion moves a few dozen chunks instead of every triangle on its own.
+const int FRACTURE_CHUNKS = 32;
+const int FRACTURE_ITERATIONS = 16;  // Lloyd iterations at most, stops earlier once no triangle changes chunk
+
+// Cache of a fracture (.fracture) written next to the source model, beside the .meshbin of the same process flags.
+// Layout: header | chunks[chunkCount] | chunk of every triangle (uint16).
+const std::uint32_t FRACTURE_CACHE_VERSION = 1;
+
+struct FractureCacheHeader {
+    char          magic[8];       // "FRACTUR"
+    std::uint32_t version;
+    std::uint32_t processFlags;   // MeshProcessBits of the meshes that were fractured
+    std::uint64_t sourceHash;     // hashModelSources of the source model
+    std::uint32_t triangleCount;
+    std::uint32_t chunkCount;
+    float         fractureMillis; // time the clustering took when the cache was written
+    std::uint32_t padding;
+};
+
+struct FractureChunk {
+    float center[3];
+    float radius;
+    float mass;
+};
+
+struct Fracture {
+    std::vector<DestructionFragment> chunks;
+    std::vector<std::uint16_t> chunkOfTriangle;
+    float fractureMillis = 0.0f;
+};
+
+// Area-weighted k-means over the triangle centroids (k-means++ seeding), so every chunk is the Voronoi
+// cell of its center. corners holds three positions per triangle. Chunks come back with their area-weighted
+// center, the distance to their farthest corner and their area as mass; none is empty.
+// Deterministic for a given seed. Touches no GL state, so it may run on a worker thread.
+Fracture fractureTriangles(const glm::vec3* corners, std::size_t triangleCount, int chunkCount = FRACTURE_CHUNKS,
+                           std::uint32_t seed = 1);
+
+// false if the file is missing, truncated, from another version or fractured different meshes
+bool loadFractureCache(const std::string& path, std::uint64_t sourceHash, std::uint32_t processFlags,
+                       std::size_t triangleCount, Fracture& fracture);
+bool writeFractureCache(const std::string& path, std::uint64_t sourceHash, std::uint32_t processFlags, const Fracture& fracture);
+
+#endif
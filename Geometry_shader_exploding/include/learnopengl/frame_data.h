@@ -0,0 +1,33 @@
+#ifndef FRAME_DATA_H
+#define FRAME_DATA_H
+
+#include <learnopengl/stream_buffer.h>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// Uniform buffer binding point of the FrameData block. Shader binds the block of every program that
+// declares it here after linking (GL 3.3 has no layout(binding) for blocks).
+const GLuint FRAME_DATA_BINDING = 0;
+const char* const FRAME_DATA_BLOCK = "FrameData";
+
+// std140 mirror of the block every vertex shader in shader/ declares:
+//     layout (std140) uniform FrameData {
+//         mat4 view; mat4 projection; mat4 viewProjection;
+//         vec4 cameraPosition; float time; float deltaTime;
+//     };
+struct FrameData {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 viewProjection;
+    glm::vec4 cameraPosition;  // w unused
+    float     time;
+    float     deltaTime;
+    float     padding[2];      // std140 rounds the block up to 16 bytes
+};
+static_assert(sizeof(FrameData) == 224, "FrameData must match the std140 layout of the shader block");
+
+// Writes data into the current frame region of stream and binds that range to FRAME_DATA_BINDING.
+// Once per frame; every program reads the same range until the next call.
+void uploadFrameData(StreamBuffer& stream, const FrameData& data);
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef GL_HANDLE_H
+#define GL_HANDLE_H
+
+#include <glad/glad.h>
+#include <learnopengl/gl_state.h>
+
+#include <utility>
+
+// Move-only owner of one GL object name; the object is deleted with the handle.
+// Converts to GLuint so it can be passed to gl* calls directly.
+template <class Deleter>
+class GLHandle {
+public:
+    GLHandle() = default;
+    explicit GLHandle(GLuint id) : id(id) {}
+    ~GLHandle() { reset(); }
+
+    GLHandle(const GLHandle&) = delete;
+    GLHandle& operator=(const GLHandle&) = delete;
+    GLHandle(GLHandle&& other) noexcept : id(std::exchange(other.id, 0)) {}
+    GLHandle& operator=(GLHandle&& other) noexcept {
+        if (this != &other) {
+            reset();
+            id = std::exchange(other.id, 0);
+        }
+        return *this;
+    }
+
+    operator GLuint() const { return id; }
+    GLuint get() const { return id; }
+    // gives up ownership without deleting
+    GLuint release() { return std::exchange(id, 0); }
+    void reset() {
+        if (id) Deleter()(id);
+        id = 0;
+    }
+
+private:
+    GLuint id = 0;
+};
+
+struct GLBufferDeleter      { void operator()(GLuint id) const { glState().forgetBuffer(id); glDeleteBuffers(1, &id); } };
+struct GLVertexArrayDeleter { void operator()(GLuint id) const { glState().forgetVertexArray(id); glDeleteVertexArrays(1, &id); } };
+struct GLTextureDeleter     { void operator()(GLuint id) const { glState().forgetTexture(id); glDeleteTextures(1, &id); } };
+struct GLQueryDeleter       { void operator()(GLuint id) const { glDeleteQueries(1, &id); } };
+
+using GLBuffer      = GLHandle<GLBufferDeleter>;
+using GLVertexArray = GLHandle<GLVertexArrayDeleter>;
+using GLTexture     = GLHandle<GLTextureDeleter>;
+using GLQuery       = GLHandle<GLQueryDeleter>;
+
+inline GLBuffer makeBuffer() {
+    GLuint id;
+    glGenBuffers(1, &id);
+    return GLBuffer(id);
+}
+
+inline GLVertexArray makeVertexArray() {
+    GLuint id;
+    glGenVertexArrays(1, &id);
+    return GLVertexArray(id);
+}
+
+inline GLQuery makeQuery() {
+    GLuint id;
+    glGenQueries(1, &id);
+    return GLQuery(id);
+}
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+
+// Debug builds compare the cache against glGet* after every change unless this is defined to 0.
+#ifndef GL_STATE_VALIDATE
+#ifdef _DEBUG
+#define GL_STATE_VALIDATE 1
+#else
+#define GL_STATE_VALIDATE 0
+#endif
+#endif
+
+// texture units the cache tracks: the 16 GL 3.3 guarantees to fragment shaders, which hold the
+// material units and the ones above them (see material.h)
+const unsigned int GL_STATE_TEXTURE_UNITS = 16;
+
+struct GLStateStats {
+    std::size_t calls = 0;    // state changes requested
+    std::size_t skipped = 0;  // ... that matched the cached value and never reached GL
+};
+
+// Shadow copy of the GL state the renderer changes per draw: program, vertex array, buffer
+// bindings, 2D textures per unit, a few capabilities, blend function and point size.
+// Requests that match the cached value are dropped. Values start out unknown, so the first
+// request for each always goes through; code that changes state behind the cache's back has to
+// call invalidate(). GL thread only.
+class GLStateCache {
+public:
+    GLStateCache() { invalidate(); }
+
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vertexArray);
+    // GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER (part of the bound vertex array), GL_COPY_WRITE_BUFFER,
+    // GL_PIXEL_UNPACK_BUFFER and GL_UNIFORM_BUFFER are cached; other targets pass straight through
+    void bindBuffer(GLenum target, GLuint buffer);
+    // glBindBufferRange also sets the generic GL_UNIFORM_BUFFER binding
+    void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+    void activeTexture(GLuint unit);
+    // GL_TEXTURE_2D on unit, leaves unit active
+    void bindTexture(GLuint unit, GLuint texture);
+    // GL_BLEND, GL_DEPTH_TEST, GL_PROGRAM_POINT_SIZE and GL_RASTERIZER_DISCARD
+    void setEnabled(GLenum capability, bool enabled);
+    void blendFunc(GLenum source, GLenum destination);
+    void pointSize(float size);
+
+    // GL unbinds deleted objects and may hand their names out again; call before deleting
+    void forgetProgram(GLuint program);
+    void forgetVertexArray(GLuint vertexArray);
+    void forgetBuffer(GLuint buffer);
+    void forgetTexture(GLuint texture);
+    // every value back to unknown
+    void invalidate();
+
+    const GLStateStats& stats() const { return counters; }
+    void resetStats() { counters = GLStateStats(); }
+
+    // checks every known value against glGet* after each request; true by default with GL_STATE_VALIDATE
+    bool validate = GL_STATE_VALIDATE != 0;
+    // mismatches found so far, each one is also printed
+    std::size_t validationErrors() const { return mismatches; }
+
+private:
+    enum BufferSlot { ARRAY, ELEMENT_ARRAY, COPY_WRITE, PIXEL_UNPACK, UNIFORM, BUFFER_SLOTS };
+    enum Capability { BLEND, DEPTH_TEST, PROGRAM_POINT_SIZE, RASTERIZER_DISCARD, CAPABILITIES };
+    static const GLuint UNKNOWN = ~0u;
+
+    GLuint program = UNKNOWN;
+    GLuint vertexArray = UNKNOWN;
+    GLuint buffers[BUFFER_SLOTS] = { UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN };
+    GLuint activeUnit = UNKNOWN;
+    GLuint textures[GL_STATE_TEXTURE_UNITS];
+    int enabled[CAPABILITIES] = { -1, -1, -1, -1 };  // -1 unknown
+    GLenum blendSource = UNKNOWN, blendDestination = UNKNOWN;
+    float size = -1.0f;
+
+    GLStateStats counters;
+    std::size_t mismatches = 0;
+
+    // true when the request has to reach GL
+    bool change(GLuint& cached, GLuint value);
+    void check(const char* what, GLenum query, GLuint cached);
+    void checkAll();
+};
+
+// the cache of the one GL context
+GLStateCache& glState();
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef GPU_PARTICLES_H
+#define GPU_PARTICLES_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <learnopengl/gl_handle.h>
+#include <learnopengl/shader.h>
+
+#include <cstddef>
+
+// vertex layout of the transform feedback particle buffers
+struct GpuParticle {
+    glm::vec3 pos;
+    glm::vec3 velocity;
+    float     life;
+};
+
+// Particle state kept entirely in GPU memory.
+// Every frame a transform feedback pass reads one VBO and writes the integrated particles to the other;
+// the CPU only touches the buffers when an explosion emits new particles.
+class GpuParticleSystem {
+public:
+    GpuParticleSystem(std::size_t capacity, const char* updateShaderPath);
+    ~GpuParticleSystem();
+    GpuParticleSystem(const GpuParticleSystem&) = delete;
+    GpuParticleSystem& operator=(const GpuParticleSystem&) = delete;
+
+    // writes n particles at the ring cursor, overwriting the oldest ones once the ring wraps
+    void emit(const GpuParticle* particles, std::size_t n);
+    // gravity + integration + life decay on the GPU
+    void update(float dt);
+    // draws the current buffer as points; the caller binds a program reading location 0 (pos) and 2 (life)
+    void draw() const;
+    void clear();
+
+    std::size_t capacity() const { return capacity_; }
+    bool idle() const { return lifeLeft <= 0.0f; }
+
+private:
+    Shader updateShader;
+    UniformHandle deltaTimeUniform;
+    GLBuffer vbo[2];
+    GLVertexArray vao[2];
+    int cur = 0;
+    std::size_t capacity_, cursor = 0;
+    std::size_t used = 0;     // slots written since the last clear, drawing stops there
+    float lifeLeft = 0.0f;    // longest remaining life of any emitted particle
+};
+
+#endif
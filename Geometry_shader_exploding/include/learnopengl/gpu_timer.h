@@ -0,0 +1,36 @@
+#ifndef GPU_TIMER_H
+#define GPU_TIMER_H
+
+#include <learnopengl/gl_handle.h>
+
+#include <cstddef>
+
+// GPU time of the commands between begin() and end(), measured with GL_TIME_ELAPSED queries.
+// Results are read back GPU_TIMER_QUERIES measurements later instead of waiting for them; a measurement
+// is skipped while every query is still in flight. Only one timer may run at a time (a GL restriction).
+const int GPU_TIMER_QUERIES = 4;
+
+class GpuTimer {
+public:
+    GpuTimer();
+
+    void begin();
+    void end();
+
+    // over every result read back since the last reset()
+    double averageMillis() const { return samples_ ? totalMillis / samples_ : 0.0; }
+    std::size_t samples() const { return samples_; }
+    void reset();
+
+private:
+    GLQuery queries[GPU_TIMER_QUERIES];
+    bool pending[GPU_TIMER_QUERIES] = {};
+    int next = 0;
+    bool running = false;
+    double totalMillis = 0.0;
+    std::size_t samples_ = 0;
+
+    void collect();
+};
+
+#endif
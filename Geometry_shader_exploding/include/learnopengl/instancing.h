@@ -0,0 +1,62 @@
+#ifndef INSTANCING_H
+#define INSTANCING_H
+
+#include <learnopengl/stream_buffer.h>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <vector>
+
+// Per-instance vertex attributes (divisor 1) read by basic.vs and the explosion shaders:
+//     layout (location = 8)  in mat4 aInstanceModel;   // 8..11
+//     layout (location = 12) in vec4 aInstanceTint;
+//     layout (location = 13) in vec4 aInstanceParams;
+// Model attributes stay below 8 (see VertexFormat).
+const GLuint INSTANCE_MODEL_LOCATION = 8;
+const GLuint INSTANCE_TINT_LOCATION = 12;
+const GLuint INSTANCE_PARAMS_LOCATION = 13;
+
+struct InstanceData {
+    glm::mat4 model;
+    glm::vec4 tint = glm::vec4(1.0f);    // multiplies the diffuse texture
+    glm::vec4 params = glm::vec4(-1.0f); // x: explosion start in FrameData::time, negative while intact
+};
+static_assert(sizeof(InstanceData) == 96, "InstanceData is read as 6 tightly packed vec4 attributes");
+
+// Disabled attribute arrays read the context's current generic values. Setting those to an identity
+// model matrix and a white tint lets non-instanced draws use the same shaders unchanged.
+// Once after the context is created.
+void setInstanceDefaults();
+
+// points the instance attributes of the bound VAO at count InstanceData records starting at offset
+void enableInstanceAttributes(GLuint buffer, GLintptr offset);
+// back to the generic defaults, so later non-instanced draws from the VAO are not affected
+void disableInstanceAttributes();
+
+// Instances of one model sorted into draw groups (e.g. per LOD level and shader) every frame.
+// upload() packs all groups back to back into one stream allocation; each non-empty group is
+// then a single instanced draw.
+class InstanceGroups {
+public:
+    explicit InstanceGroups(unsigned int groupCount) : groups(groupCount), offsets(groupCount, 0) {}
+
+    void clear();
+    void add(unsigned int group, const InstanceData& instance) { groups[group].push_back(instance); }
+    // false when the stream region cannot hold every instance; nothing should be drawn then
+    bool upload(StreamBuffer& stream);
+
+    unsigned int groupCount() const { return (unsigned int)groups.size(); }
+    GLsizei count(unsigned int group) const { return (GLsizei)groups[group].size(); }
+    std::size_t total() const;
+    // valid after upload()
+    GLuint buffer() const { return uploadedBuffer; }
+    GLintptr offset(unsigned int group) const { return offsets[group]; }
+
+private:
+    std::vector<std::vector<InstanceData>> groups;
+    std::vector<GLintptr> offsets;
+    GLuint uploadedBuffer = 0;
+};
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef MATERIAL_H
+#define MATERIAL_H
+
+#include <glad/glad.h>
+#include <learnopengl/gl_state.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Texture roles a material can use. Shaders sample them through texture_<type>N uniforms
+// (texture_diffuse1, texture_specular2, ...), N counting from 1 per type.
+enum class TextureType : std::uint8_t { Diffuse, Specular, Normal, Height, Count };
+
+const unsigned int TEXTURE_TYPE_COUNT = (unsigned int)TextureType::Count;
+// Every sampler gets a fixed unit: type * MAX_TEXTURES_PER_TYPE + N - 1. Three per type leave the
+// top of the 16 units GL 3.3 guarantees for textures no material owns (DESTRUCTION_TEXTURE_UNIT).
+const unsigned int MAX_TEXTURES_PER_TYPE = 3;
+const unsigned int MATERIAL_TEXTURE_UNITS = TEXTURE_TYPE_COUNT * MAX_TEXTURES_PER_TYPE;
+
+inline const char* textureTypeName(TextureType type) {
+    static const char* const names[TEXTURE_TYPE_COUNT] = {
+        "texture_diffuse", "texture_specular", "texture_normal", "texture_height"
+    };
+    return type < TextureType::Count ? names[(unsigned int)type] : "";
+}
+
+// TextureType::Count for names that are not a texture type
+inline TextureType textureTypeFromName(const std::string& name) {
+    for (unsigned int t = 0; t < TEXTURE_TYPE_COUNT; t++) {
+        if (name == textureTypeName((TextureType)t))
+            return (TextureType)t;
+    }
+    return TextureType::Count;
+}
+
+// unit of the n-th (0-based) texture of a type
+inline GLuint textureUnit(TextureType type, unsigned int n) {
+    return (GLuint)type * MAX_TEXTURES_PER_TYPE + n;
+}
+
+// unit a texture_<type>N sampler uniform is assigned to; false for any other name
+inline bool samplerUnit(const std::string& uniformName, GLuint& unit) {
+    for (unsigned int t = 0; t < TEXTURE_TYPE_COUNT; t++) {
+        const char* prefix = textureTypeName((TextureType)t);
+        std::size_t length = std::strlen(prefix);
+        if (uniformName.compare(0, length, prefix) != 0 || uniformName.size() == length)
+            continue;
+        char* end = nullptr;
+        long n = std::strtol(uniformName.c_str() + length, &end, 10);
+        if (*end != '\0' || n < 1 || n > (long)MAX_TEXTURES_PER_TYPE)
+            return false;
+        unit = textureUnit((TextureType)t, (unsigned int)n - 1);
+        return true;
+    }
+    return false;
+}
+
+// non-owning description of a texture; the GL name is owned by the Model that loaded it
+struct Texture {
+    unsigned int id;
+    TextureType type;
+};
+
+// texture to bind to a unit, resolved once per material
+struct TextureBinding {
+    GLuint unit;
+    GLuint id;
+};
+
+// One binding per sampler unit, in unit order. Units the material has no texture for get 0, so a
+// draw never samples what the previous material left bound there. Textures past MAX_TEXTURES_PER_TYPE
+// of their type have no sampler and are left out.
+inline std::vector<TextureBinding> makeTextureBindings(const std::vector<Texture>& textures) {
+    std::vector<TextureBinding> bindings(MATERIAL_TEXTURE_UNITS);
+    for (GLuint unit = 0; unit < (GLuint)bindings.size(); unit++)
+        bindings[unit] = TextureBinding{ unit, 0 };
+    unsigned int count[TEXTURE_TYPE_COUNT] = {};
+    for (const Texture& texture : textures) {
+        if (texture.type >= TextureType::Count)
+            continue;
+        unsigned int& n = count[(unsigned int)texture.type];
+        if (n < MAX_TEXTURES_PER_TYPE)
+            bindings[textureUnit(texture.type, n++)].id = texture.id;
+    }
+    return bindings;
+}
+
+// FNV-1a over the whole binding table, so materials binding the same textures share a sort key
+inline std::uint32_t materialHash(const std::vector<TextureBinding>& bindings) {
+    std::uint32_t hash = 2166136261u;
+    for (const TextureBinding& binding : bindings) {
+        hash = (hash ^ binding.unit) * 16777619u;
+        hash = (hash ^ binding.id) * 16777619u;
+    }
+    return hash;
+}
+
+// Samplers already point at their units (Shader sets them after linking), so a draw only binds names;
+// the state cache skips the units that already hold the right one.
+inline void bindTextures(const std::vector<TextureBinding>& bindings) {
+    for (const TextureBinding& binding : bindings)
+        glState().bindTexture(binding.unit, binding.id);
+}
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <learnopengl/model.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Binary cache of processed meshes (.meshbin) written next to the source model, one per processedCachePath.
+// Layout: header | entries[meshCount] | textures[textureCount] | 16-byte aligned vertex/index blobs.
+// The blobs use the in-memory Vertex layout, so a mapped file can be handed to glBufferData as is.
+const std::uint32_t MESH_CACHE_VERSION = 7;
+
+// passes run after the Assimp import and baked into the cached data
+enum MeshProcessBits : std::uint32_t {
+    MESH_PROCESS_OPTIMIZE = 1 << 0,  // optimizeMesh
+    MESH_PROCESS_LODS     = 1 << 1   // simplified LOD index ranges
+};
+
+struct MeshCacheHeader {
+    char          magic[8];      // "MESHBIN"
+    std::uint32_t version;
+    std::uint32_t vertexSize;    // sizeof(Vertex) of the writer
+    std::uint64_t sourceHash;    // hashModelSources of the source model
+    std::uint32_t importFlags;   // aiPostProcessSteps used for the import
+    std::uint32_t processFlags;  // MeshProcessBits applied afterwards
+    std::uint32_t meshCount;
+    std::uint32_t textureCount;
+    float         importMillis;  // time Assimp + processing took when the cache was written
+    std::uint32_t padding;
+};
+
+struct MeshCacheEntry {
+    std::uint64_t vertexOffset, vertexCount;
+    std::uint64_t indexOffset, indexCount;  // full detail followed by the LODs
+    std::uint32_t firstTexture, textureCount;
+    float         boundsMin[3], boundsMax[3];
+    float         sphere[4];     // center, radius
+    std::uint32_t attributes;    // VertexAttributeBits the importer provided
+    std::uint32_t detailIndexCount;
+    std::uint32_t lodCount;
+    std::uint32_t lodFirstIndex[MAX_MESH_LODS], lodIndexCount[MAX_MESH_LODS];
+    float         lodError[MAX_MESH_LODS];
+    std::uint32_t padding;
+};
+
+struct MeshCacheTexture {
+    char type[32];
+    char path[224];
+};
+
+// read-only memory mapping of a whole file
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const unsigned char* data() const { return bytes; }
+    std::size_t size() const { return length; }
+    explicit operator bool() const { return bytes != nullptr; }
+
+private:
+    const unsigned char* bytes = nullptr;
+    std::size_t length = 0;
+#ifdef _WIN32
+    void* file = nullptr;
+    void* mapping = nullptr;
+#endif
+};
+
+// "<path>[.o][l]<extension>": one cache file per set of MeshProcessBits (o = optimize, l = LODs),
+// so loads with different options never overwrite each other's cache
+std::string processedCachePath(const std::string& path, std::uint32_t processFlags, const char* extension);
+
+// FNV-1a over the file contents, 0 if the file cannot be read
+std::uint64_t hashFile(const std::string& path);
+
+// hashFile of a model combined with the material libraries it references (the mtllib lines of an .obj),
+// so editing a material or one of its texture paths invalidates the caches built from the model
+std::uint64_t hashModelSources(const std::string& path);
+
+// path + ".<process>-<n>.tmp", unique per call, so concurrent writers of one cache never share a temporary
+std::string uniqueTempPath(const std::string& path);
+
+// Writes a cache file through a uniqueTempPath renamed over path once complete, so a crash never leaves
+// a half-written cache behind. False if the stream failed or the rename did; the temporary is removed then.
+bool writeFileReplacing(const std::string& path, const std::function<void(std::ostream&)>& write);
+
+// validated pointers into a mapped cache file
+struct MeshCacheView {
+    const MeshCacheHeader*  header = nullptr;
+    const MeshCacheEntry*   entries = nullptr;
+    const MeshCacheTexture* textures = nullptr;
+    const unsigned char*    base = nullptr;
+
+    const Vertex* vertices(const MeshCacheEntry& e) const { return (const Vertex*)(base + e.vertexOffset); }
+    const unsigned int* indices(const MeshCacheEntry& e) const { return (const unsigned int*)(base + e.indexOffset); }
+};
+
+// false if the file is missing, truncated, from another version or built from different source / flags
+bool openMeshCache(const MappedFile& file, std::uint64_t sourceHash, std::uint32_t importFlags, std::uint32_t processFlags,
+                   MeshCacheView& view);
+
+bool writeMeshCache(const std::string& path, std::uint64_t sourceHash, std::uint32_t importFlags, std::uint32_t processFlags,
+                    float importMillis, const std::vector<MeshData>& meshes);
+
+#endif
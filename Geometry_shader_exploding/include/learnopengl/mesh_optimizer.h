@@ -0,0 +1,38 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <learnopengl/mesh.h>
+
+#include <cstddef>
+#include <vector>
+
+// FIFO post-transform cache size used for the ACMR / ATVR figures
+const unsigned int VERTEX_CACHE_SIZE = 16;
+
+struct VertexCacheStats {
+    float acmr;  // vertex shader invocations per triangle (0.5 is ideal for a regular grid, 3 for a triangle soup)
+    float atvr;  // vertex shader invocations per referenced vertex (1 is ideal)
+};
+
+VertexCacheStats analyzeVertexCache(const unsigned int* indices, std::size_t indexCount, std::size_t vertexCount,
+                                    unsigned int cacheSize = VERTEX_CACHE_SIZE);
+
+// merges bit-identical vertices and rewrites indices to match
+void weldVertices(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+// triangle order for post-transform cache hits (Forsyth, "Linear-Speed Vertex Cache Optimisation")
+void optimizeVertexCache(std::vector<unsigned int>& indices, std::size_t vertexCount);
+// Sorts runs of the cache-optimized order so outward facing parts of the mesh come first and occlude the rest.
+// The cache order is kept when sorting would raise ACMR by more than threshold.
+void optimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<Vertex>& vertices, float threshold = 1.05f);
+// vertices in the order the index buffer first uses them, unreferenced ones dropped
+void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+struct MeshOptimizationReport {
+    std::size_t verticesBefore, verticesAfter;
+    VertexCacheStats before, after;
+};
+
+// every pass above, in order
+MeshOptimizationReport optimizeMesh(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+#endif
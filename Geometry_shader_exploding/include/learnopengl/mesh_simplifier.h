@@ -0,0 +1,18 @@
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+
+#include <learnopengl/mesh.h>
+
+#include <cstddef>
+#include <vector>
+
+// Quadric error metric simplification (Garland & Heckbert) by half-edge collapses.
+// Only the index buffer changes: every collapse moves a vertex onto one of its neighbours, so all
+// levels of detail share the original vertex buffer. Vertices split by UV / normal seams collapse
+// together along the seam, open borders only collapse along the border, non-manifold vertices are kept.
+// Writes at most targetIndexCount indices to out (more if the mesh cannot be reduced that far) and
+// returns the largest object-space deviation a collapse introduced.
+float simplifyMesh(const Vertex* vertices, std::size_t vertexCount, const unsigned int* indices, std::size_t indexCount,
+                   std::size_t targetIndexCount, std::vector<unsigned int>& out);
+
+#endif
@@ -5,31 +5,259 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <learnopengl/culling.h>
+#include <learnopengl/destruction.h>
+#include <learnopengl/explode_mesh.h>
+#include <learnopengl/gl_handle.h>
+#include <learnopengl/instancing.h>
+#include <learnopengl/material.h>
 #include <learnopengl/mesh.h>
 #include <learnopengl/shader.h>
+#include <learnopengl/vertex_format.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <assimp/scene.h>
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 
+class AssetManager;
+class MappedFile;
+
+// 8-bit image decoded by stb_image, rows flipped for GL; owns the pixel allocation
+struct DecodedImage {
+    unsigned char* pixels = nullptr;
+    int width = 0, height = 0, channels = 0;
+
+    DecodedImage() = default;
+    DecodedImage(DecodedImage&& other) noexcept { *this = std::move(other); }
+    DecodedImage& operator=(DecodedImage&& other) noexcept {
+        std::swap(pixels, other.pixels);
+        std::swap(width, other.width);
+        std::swap(height, other.height);
+        std::swap(channels, other.channels);
+        return *this;
+    }
+    ~DecodedImage();
+
+    std::size_t size() const { return (std::size_t)width * height * channels; }
+    explicit operator bool() const { return pixels != nullptr; }
+};
+
+// touches no GL state, so it may run on a worker thread
+DecodedImage decodeImage(const std::string& file);
+// mipmapped, repeating 2D texture; pixels is image.pixels or an offset into the bound GL_PIXEL_UNPACK_BUFFER
+unsigned int TextureFromImage(const DecodedImage& image, const void* pixels);
 unsigned int TextureFromFile(const char* path, const std::string& directory, bool gamma = false);
 
+struct ModelLoadOptions {
+    // attributes / quantization uploaded per mesh (see VertexFormat::consumedBy)
+    VertexFormat format;
+    // load from / write to "<path>[.o][l].meshbin" (see processedCachePath) instead of running Assimp every launch
+    bool useCache = true;
+    // weld duplicate vertices and reorder for vertex cache, overdraw and fetch locality at import (see optimizeMesh)
+    bool optimize = false;
+    // simplified index buffers at MESH_LOD_RATIOS of the triangles, selected per instance with LodSelector
+    bool generateLods = false;
+    // de-indexed copy of the full detail with per-face attributes, for DrawExplodedInstanced
+    bool explodable = false;
+    // free the CPU-side vertices / indices once they are on the GPU
+    bool keepCpuData = true;
+    // shares textures with every other model loaded through the same manager
+    AssetManager* assets = nullptr;
+};
+
+// texture named by a material, path relative to the model directory
+struct TextureRef {
+    std::string path;
+    TextureType type;
+};
+
+// levels of detail below the full mesh and their share of its triangles
+const unsigned int MAX_MESH_LODS = 4;
+const float MESH_LOD_RATIOS[MAX_MESH_LODS] = { 0.5f, 0.25f, 0.10f, 0.03f };
+
+// simplified index range appended to a mesh's indices
+struct MeshLod {
+    std::size_t firstIndex;
+    std::size_t indexCount;
+    float error;  // object-space deviation from the full mesh
+};
+
+// One imported mesh before upload. Vertices / indices live in the vectors, or for a mesh cache hit
+// in the mapping kept alive by the owning ModelData.
+struct MeshData {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    const Vertex* mappedVertices = nullptr;
+    const unsigned int* mappedIndices = nullptr;
+    std::size_t vertexCount = 0, indexCount = 0;  // indexCount is the full detail, LOD indices follow it
+    std::vector<MeshLod> lods;
+    std::vector<ExplodeVertex> explodeVertices;  // ModelLoadOptions::explodable, never cached
+    std::vector<TextureRef> textures;
+    unsigned int available = VERTEX_ALL;
+    glm::vec3 boundsMin = glm::vec3(0.0f), boundsMax = glm::vec3(0.0f);
+    BoundingSphere sphere = { glm::vec3(0.0f), 0.0f };
+
+    const Vertex* vertexData() const { return mappedVertices ? mappedVertices : vertices.data(); }
+    const unsigned int* indexData() const { return mappedIndices ? mappedIndices : indices.data(); }
+    // full detail plus every LOD
+    std::size_t totalIndexCount() const { return lods.empty() ? indexCount : lods.back().firstIndex + lods.back().indexCount; }
+};
+
+// CPU half of a model load (see Model::import)
+struct ModelData {
+    std::string path;
+    std::string directory;
+    std::vector<MeshData> meshes;
+    DestructionBake destruction;              // ModelLoadOptions::explodable
+    std::shared_ptr<const MappedFile> cache;  // backs the mapped mesh data
+    float importMillis = 0.0f;
+    bool valid = false;
+};
+
+// textures one or more sub-meshes are drawn with
+struct Material {
+    std::vector<Texture> textures;
+    std::vector<TextureBinding> bindings;  // what Draw binds, in unit order
+    std::uint32_t key;                     // materialHash of bindings
+};
+
+struct IndexRange {
+    GLuint firstIndex;      // in indices, not bytes
+    GLsizei indexCount;
+};
+
+// one sub-mesh inside the model's shared vertex / index buffers
+struct DrawRange {
+    GLint baseVertex;       // added to every index of the range
+    GLuint firstIndex;      // full detail
+    GLsizei indexCount;
+    GLsizei vertexCount;
+    unsigned int material;  // into Model::getMaterials()
+    glm::vec3 boundsMin, boundsMax;
+    BoundingSphere sphere;
+    unsigned int lodCount;  // simplified levels in lods, sharing the vertices of the full detail
+    IndexRange lods[MAX_MESH_LODS];
+    GLint explodeFirst;     // vertices in the explode buffer (none without ModelLoadOptions::explodable)
+    GLsizei explodeCount;
+
+    // level 0 is the full detail; levels past the coarsest available clamp to it
+    IndexRange level(unsigned int lod) const {
+        if (lod == 0 || lodCount == 0)
+            return IndexRange{ firstIndex, indexCount };
+        return lods[std::min(lod, lodCount) - 1];
+    }
+};
+
+// All meshes of a model share one VAO, vertex buffer and index buffer; each mesh is a DrawRange drawn
+// with glDrawElementsBaseVertex. Owns every GL object it uses, so it can be moved but not copied.
 class Model {
 public:
-    Model(const std::string& path) { loadModel(path); }
-    void Draw(Shader& shader);
+    Model(const std::string& path, const ModelLoadOptions& options = ModelLoadOptions())
+        : Model(import(path, options), options) {}
+    // GL half of a load: uploads meshes and textures of an earlier import
+    Model(ModelData data, const ModelLoadOptions& options = ModelLoadOptions());
+    Model(const Model&) = delete;
+    Model& operator=(const Model&) = delete;
+    Model(Model&&) noexcept = default;
+    Model& operator=(Model&&) noexcept = default;
+
+    // Assimp import or mesh cache mapping plus vertex processing; makes no GL calls, so it may run on a worker thread
+    static ModelData import(const std::string& path, const ModelLoadOptions& options = ModelLoadOptions());
+    // untextured unit cube centered on the origin, drawn while the real model is still loading
+    static Model placeholder(const ModelLoadOptions& options = ModelLoadOptions());
+
+    // lod: 0 for full detail, up to lodLevels() - 1
+    void Draw(Shader& shader, unsigned int lod = 0);
+    // instanceCount copies in one call per range, each placed by the InstanceData at instanceOffset in instanceBuffer
+    void DrawInstanced(Shader& shader, GLuint instanceBuffer, GLintptr instanceOffset, GLsizei instanceCount,
+                       unsigned int lod = 0);
+    // same from the explodable variant with the bound program, one reading ExplodeVertex (shader/explode.vs,
+    // shader/destruction.vs); its vertices are not quantized, so there are no layout uniforms to set
+    void DrawExplodedInstanced(GLuint instanceBuffer, GLintptr instanceOffset, GLsizei instanceCount);
+    // for shader/destruction.vs only: the baked frames on DESTRUCTION_TEXTURE_UNIT and their rate in fps
+    void bindDestruction(Shader& shader, UniformHandle fps) const;
+    bool explodable() const { return explodeVertexCount > 0; }
+    // vertices one instance of the explodable variant draws
+    std::size_t explodedVertexCount() const { return explodeVertexCount; }
+    GLuint explodeVertexArray() const { return explodeVAO; }
+    bool hasDestruction() const { return destructionTexture != 0; }
+    // farthest a baked fragment gets from the bounding center, in object space
+    float destructionReach() const { return destructionReach_; }
+    const std::vector<DrawRange>& getRanges() const { return ranges; }
+    GLuint vertexArray() const { return VAO; }
+    // binding table the first range is drawn with, to group draws of equal materials (0 for none)
+    unsigned int materialKey() const { return materials.empty() ? 0 : materials[0].key; }
+    unsigned int lodLevels() const { return (unsigned int)lodErrors.size(); }
+    // largest deviation of any range at that level, in object space
+    float lodError(unsigned int lod) const { return lodErrors[std::min(lod, lodLevels() - 1)]; }
+    std::size_t triangleCount(unsigned int lod = 0) const;
+    // object-space bounds of all ranges, and a sphere around them
+    glm::vec3 boundsMin() const { return bounds[0]; }
+    glm::vec3 boundsMax() const { return bounds[1]; }
+    const BoundingSphere& boundingSphere() const { return sphere; }
+    glm::vec3 boundingCenter() const { return sphere.center; }
+    float boundingRadius() const { return sphere.radius; }
+    const std::vector<Material>& getMaterials() const { return materials; }
+    const VertexLayout& getLayout() const { return layout; }
+    // imported meshes, only kept with ModelLoadOptions::keepCpuData
+    const ModelData& getCpuData() const { return cpuData; }
 
 private:
-    std::vector<Texture> textures_loaded;
-    std::vector<Mesh> meshes;
+    struct LayoutUniforms {
+        GLuint program;
+        UniformHandle offset, scale;  // positionOffset, positionScale
+    };
+
+    std::unordered_map<std::string, Texture> textures_loaded;  // by path as written in the material
+    std::vector<std::shared_ptr<GLTexture>> textureObjects;     // keeps the names referenced by textures_loaded alive
+    GLVertexArray VAO;
+    GLBuffer VBO, EBO;
+    GLVertexArray explodeVAO;
+    GLBuffer explodeVBO;
+    std::size_t explodeVertexCount = 0;
+    GLTexture destructionTexture;
+    float destructionFps = DESTRUCTION_BAKE_FPS;
+    float destructionReach_ = 0.0f;
+    VertexLayout layout;
+    GLenum indexType = GL_UNSIGNED_INT;
+    std::vector<DrawRange> ranges;
+    std::vector<Material> materials;
+    std::vector<LayoutUniforms> layoutUniforms;  // one per program the model was drawn with
+    std::vector<float> lodErrors{ 0.0f };
+    glm::vec3 bounds[2] = { glm::vec3(0.0f), glm::vec3(0.0f) };
+    BoundingSphere sphere = { glm::vec3(0.0f), 0.0f };
+    ModelData cpuData;
     std::string directory;
+    ModelLoadOptions options;
+
+    Texture loadTexture(const char* path, TextureType type);
+    unsigned int findMaterial(std::vector<Texture> textures);
+    void upload(const std::vector<MeshData>& meshes);
+    void setLayoutUniforms(const Shader& shader);
+    void reportVertexFormat(const std::string& path) const;
+};
+
+// Per-instance LOD choice by screen-space error: the coarsest level whose error, projected at the
+// instance's distance, stays below maxErrorPixels. Switching to a coarser level needs a margin of
+// LOD_HYSTERESIS below the limit, so an instance hovering at a threshold does not pop back and forth.
+const float LOD_HYSTERESIS = 0.25f;
 
-    void loadModel(std::string const& path);
-    void processNode(aiNode* node, const aiScene* scene);
-    Mesh processMesh(aiMesh* mesh, const aiScene* scene);
-    std::vector<Texture> loadMaterialTextures(aiMaterial* mat, aiTextureType type, std::string typeName);
+struct LodSelector {
+    unsigned int level = 0;
+
+    // radiusPixels: projected radius of the instance's bounding sphere
+    unsigned int select(const Model& model, float radiusPixels, float maxErrorPixels = 1.0f);
 };
 
+// screen-space radius in pixels of a world-space sphere under a perspective projection
+float projectedRadius(const glm::vec3& center, float radius, const glm::vec3& cameraPos, float fovY, float viewportHeight);
+
 #endif
\ No newline at end of file
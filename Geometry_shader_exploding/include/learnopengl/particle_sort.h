@@ -0,0 +1,103 @@
+#ifndef PARTICLE_SORT_H
+#define PARTICLE_SORT_H
+
+#include <learnopengl/particles.h>
+
+#include <glm/glm.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// view depth quantized to this many bits over [0, far]: two passes of PARTICLE_SORT_DIGIT_BITS
+const unsigned int PARTICLE_DEPTH_BITS = 22;
+const unsigned int PARTICLE_SORT_DIGIT_BITS = 11;
+// fewer keys than this are sorted by one thread, waking the others would cost more than it saves;
+// a full CPU particle pool (MAX_PARTICLES, 20k) is above it
+const std::size_t PARTICLE_SORT_PARALLEL_MIN = 16 * 1024;
+// camera motion since the last full sort within which the previous order is only repaired
+const float PARTICLE_RESORT_DISTANCE = 0.25f;
+const float PARTICLE_RESORT_COS = 0.9994f;  // about 2 degrees of turn
+// element moves per particle the repair may take before it gives up and sorts from scratch
+const std::size_t PARTICLE_RESORT_MOVES = 4;
+
+// Threads of the parallel radix sort, started once and parked between sorts.
+class SortThreads {
+public:
+    // count includes the calling thread, which always takes slice 0
+    explicit SortThreads(unsigned int count);
+    ~SortThreads();
+    SortThreads(const SortThreads&) = delete;
+    SortThreads& operator=(const SortThreads&) = delete;
+
+    unsigned int count() const { return (unsigned int)workers.size() + 1; }
+    // job(t) for every t below count(), returns once all of them have finished
+    void run(const std::function<void(unsigned int)>& job);
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake, done;
+    const std::function<void(unsigned int)>* job = nullptr;
+    std::size_t generation = 0;  // one per run()
+    unsigned int busy = 0;       // workers still in the current job
+    bool stopping = false;
+
+    void workerLoop(unsigned int t);
+};
+
+// Stable LSD radix sort of items by their upper 32 bits (a depth key of PARTICLE_DEPTH_BITS), the lower
+// 32 bits being the payload. Each pass handles one 11-bit digit; with threads every thread histograms
+// its slice, the histograms are prefix-summed digit by digit across the threads, and every thread scatters
+// its slice to its own offsets. Passes where all keys share the digit are skipped.
+void radixSortDepthKeys(std::vector<std::uint64_t>& items, std::vector<std::uint64_t>& scratch, SortThreads* threads = nullptr);
+
+struct ParticleSortStats {
+    std::size_t fullSorts = 0, repairs = 0;
+    double fullMillis = 0.0, repairMillis = 0.0;  // summed, keys included
+};
+
+// Back-to-front order of a ParticlePool's live particles for alpha blending.
+// While the camera stays within PARTICLE_RESORT_DISTANCE / PARTICLE_RESORT_COS of where the last full sort
+// was made, the previous order is re-keyed and repaired by insertion sort, which is linear for the nearly
+// sorted orders a still camera produces; otherwise, or when the repair runs over budget, the keys are radix sorted.
+class ParticleDepthSorter {
+public:
+    // threads = 0 uses the hardware threads (at most 8), started by the first sort large enough to share
+    explicit ParticleDepthSorter(unsigned int threads = 0);
+
+    // indices of pool's live particles, farthest first along forward (unit length) from cameraPos;
+    // depths beyond farDepth share the largest key
+    const std::vector<std::uint32_t>& sort(const ParticlePool& pool, const glm::vec3& cameraPos, const glm::vec3& forward,
+                                           float farDepth);
+    // the next sort starts from scratch
+    void invalidate() { valid = false; }
+
+    unsigned int threads() const { return threadCount; }
+    const ParticleSortStats& stats() const { return stats_; }
+
+private:
+    unsigned int threadCount;
+    std::unique_ptr<SortThreads> workers;
+    std::vector<std::uint32_t> keys;  // by particle index
+    std::vector<std::uint64_t> items, scratch;
+    std::vector<std::uint32_t> order;
+    bool valid = false;
+    glm::vec3 sortedFrom = glm::vec3(0.0f), sortedAlong = glm::vec3(0.0f);
+    std::size_t sortedCount = 0;
+    ParticleSortStats stats_;
+
+    bool repair(std::size_t budget);
+};
+
+// times full sorts (one thread, all threads, std::sort, keys included in each) and repairs after a small
+// camera move at 10k, 100k and 1M particles, checks both radix orders against std::stable_sort and prints
+// the results
+void benchmarkParticleSort();
+
+#endif
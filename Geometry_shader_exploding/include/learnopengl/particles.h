@@ -0,0 +1,84 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// lane width of the vectorized update
+const std::size_t PARTICLE_LANES = 8;
+
+enum class ParticleKernel {
+    Scalar,  // reference path, one particle at a time
+    Simd     // AVX2 / SSE / NEON, 8 particles per step
+};
+
+// one explosion (or any other source) asking the pool for particles
+struct ParticleEmitter {
+    std::size_t  budget;    // particles requested per emit
+    std::uint8_t priority;  // may steal particles of equal or lower priority when the pool is full
+};
+
+// contiguous slots handed out by ParticlePool::allocate
+struct ParticleRange {
+    std::size_t first;
+    std::size_t count;
+};
+
+// Structure-of-arrays particle storage.
+// Live particles are kept compacted in [0, count) so the update never touches dead slots;
+// the tail [count, capacity) is the free list, so allocation is a bump of count.
+class ParticlePool {
+public:
+    std::vector<float> x, y, z;
+    std::vector<float> vx, vy, vz;
+    std::vector<float> life;
+    std::vector<std::uint8_t> priority;
+    std::size_t count = 0;
+    std::size_t stolen = 0;  // particles reclaimed by allocate since the last clear
+
+    explicit ParticlePool(std::size_t capacity = 0) { resize(capacity); }
+
+    void resize(std::size_t capacity);
+    std::size_t capacity() const { return capacity_; }
+    void clear() { count = 0; stolen = 0; }
+
+    // Reserves up to n particles. When the pool is full the oldest particles (least life left)
+    // with priority <= the requested one are stolen; the range is shorter if not enough can be freed.
+    ParticleRange allocate(std::size_t n, std::uint8_t priority);
+    ParticleRange allocate(const ParticleEmitter& emitter) { return allocate(emitter.budget, emitter.priority); }
+    void set(std::size_t i, const glm::vec3& pos, const glm::vec3& velocity, float life);
+
+    // swap-removes particle i with the last live particle
+    void kill(std::size_t i);
+    // swap-removes every particle whose life ran out
+    void compact();
+
+    // writes interleaved xyz of live particles into dst, returns the number written
+    std::size_t gatherPositions(glm::vec3* dst) const;
+    // same for the n particles order[0, n), in that order
+    std::size_t gatherPositions(const std::uint32_t* order, std::size_t n, glm::vec3* dst) const;
+
+private:
+    std::size_t capacity_ = 0;
+    std::vector<std::uint32_t> candidates_;  // scratch for allocate
+
+    std::size_t steal(std::size_t n, std::uint8_t priority);
+};
+
+// gravity + integration + life decay, then compaction of particles whose life ran out.
+// Both kernels perform the same float operations in the same order, so their results are bit-identical.
+void updateParticles(ParticlePool& pool, float dt, ParticleKernel kernel = ParticleKernel::Simd);
+void updateParticlesScalar(ParticlePool& pool, float dt);
+void updateParticlesSimd(ParticlePool& pool, float dt);
+
+// Runs both kernels over the same seeded pool for steps frames and compares every field bit for bit.
+// Returns false on the first difference.
+bool verifyParticleKernels(std::size_t count = 1003, unsigned int seed = 1, int steps = 90);
+
+// name of the instruction set used by updateParticlesSimd
+const char* particleSimdName();
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// 64-bit sort key, most significant bits first:
+//   pass (4) | transparent (1) | opaque:      program (10) | vertex array (12) | material (12) | depth (24)
+//                              | transparent: inverted depth (24) | program (10) | vertex array (12) | material (12)
+// Opaque packets are grouped by state and drawn front to back within a group; transparent ones are
+// drawn back to front regardless of state, after every opaque packet of their pass.
+const unsigned int SORT_KEY_DEPTH_BITS = 24;
+
+struct SortKeyFields {
+    unsigned int pass = 0;         // passes run in increasing order
+    bool transparent = false;
+    unsigned int program = 0;      // GL names; only the low bits take part, so collisions only cost order
+    unsigned int vertexArray = 0;
+    unsigned int material = 0;
+    float depth = 0.0f;            // view distance divided by the far plane, clamped to [0, 1]
+};
+
+std::uint64_t makeSortKey(const SortKeyFields& fields);
+
+// Sorts 64-bit keys with their payload, least significant byte first. Bytes every key shares are
+// skipped, so keys that only differ in a few fields cost only as many passes.
+struct SortItem {
+    std::uint64_t key;
+    std::uint32_t index;
+};
+void radixSort(std::vector<SortItem>& items, std::vector<SortItem>& scratch);
+
+struct RenderQueueStats {
+    std::size_t packets = 0;
+    std::size_t stateChanges = 0;          // program / vertex array / material switches in sorted order
+    std::size_t unsortedStateChanges = 0;  // ... had the packets run in submission order
+    std::size_t saved() const { return unsortedStateChanges > stateChanges ? unsortedStateChanges - stateChanges : 0; }
+};
+
+// Per-frame list of draw packets. Systems submit a key and the GL work for one draw; execute()
+// sorts by key and runs them, so scene logic never issues GL calls itself.
+// Commands are copied into an arena of fixed blocks that is kept across frames, so once it has grown
+// to a frame's worth, submitting never allocates. The arena is reset without running destructors,
+// so a command may only capture trivially destructible state (references, GL names, matrices).
+class RenderQueue {
+public:
+    static const std::size_t ARENA_BLOCK_SIZE = 16 * 1024;
+
+    void clear();
+    template <class Command>
+    void submit(const SortKeyFields& fields, const Command& command) { submit(makeSortKey(fields), command); }
+    template <class Command>
+    void submit(std::uint64_t key, const Command& command) {
+        static_assert(std::is_trivially_destructible<Command>::value, "render commands are never destroyed");
+        static_assert(sizeof(Command) <= ARENA_BLOCK_SIZE && alignof(Command) <= alignof(std::max_align_t),
+                      "render command does not fit an arena block");
+        void* storage = allocate(sizeof(Command), alignof(Command));
+        new (storage) Command(command);
+        items.push_back(SortItem{ key, (std::uint32_t)packets.size() });
+        packets.push_back(Packet{ &run<Command>, storage });
+    }
+    // sorts, runs every packet in key order and clears the queue
+    void execute();
+
+    // of the last execute()
+    const RenderQueueStats& stats() const { return stats_; }
+
+private:
+    struct Packet {
+        void (*run)(const void* command);
+        const void* command;  // in the arena
+    };
+    template <class Command>
+    static void run(const void* command) { (*static_cast<const Command*>(command))(); }
+
+    std::vector<Packet> packets;
+    std::vector<SortItem> items, scratch;
+    std::vector<std::unique_ptr<std::max_align_t[]>> blocks;
+    std::size_t block = 0, used = 0;  // bump position in blocks[block]
+    RenderQueueStats stats_;
+
+    void* allocate(std::size_t size, std::size_t alignment);
+};
+
+#endif
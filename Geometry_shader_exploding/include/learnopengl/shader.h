@@ -2,9 +2,32 @@
 #define SHADER_H
 
 #include <string>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+// FNV-1a, usable in constant expressions so names written as literals hash at compile time
+constexpr std::uint32_t uniformHash(const char* name, std::uint32_t hash = 2166136261u) {
+    return *name ? uniformHash(name + 1, (hash ^ (std::uint8_t)*name) * 16777619u) : hash;
+}
+
+// Uniform name as its hash. Literals convert implicitly (setMat4("model", m)); a constexpr
+// UniformName guarantees the hash is folded, e.g. constexpr UniformName MODEL("model").
+struct UniformName {
+    std::uint32_t hash;
+
+    template <std::size_t N>
+    constexpr UniformName(const char (&name)[N]) : hash(uniformHash(name)) {}
+    UniformName(const std::string& name) : hash(uniformHash(name.c_str())) {}
+};
+
+// resolved location; setters taking a handle do no lookup at all
+struct UniformHandle {
+    GLint location = -1;  // -1: not an active uniform, glUniform* ignores it
+};
+
 class Shader {
 public:
     unsigned int ID;
@@ -13,12 +36,33 @@ public:
     Shader(const char* vertexPath, const char* fragmentPath);
     // VS+FS+GS 
     Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath);
+    // VS only, captures the given outputs with transform feedback (interleaved)
+    Shader(const char* vertexPath, const char* const* feedbackVaryings, int varyingCount);
 
     void use() const;
-    void setBool(const std::string& name, bool      value) const;
-    void setInt(const std::string& name, int       value) const;
-    void setFloat(const std::string& name, float    value) const;
-    void setMat4(const std::string& name, const glm::mat4& mat) const;
+
+    // Names are looked up in the table reflected after linking; glGetUniformLocation is never
+    // called here. Names that are not active uniforms resolve to -1 and are ignored.
+    UniformHandle uniform(UniformName name) const;
+    void setBool(UniformName name, bool      value) const;
+    void setInt(UniformName name, int       value) const;
+    void setFloat(UniformName name, float    value) const;
+    void setVec3(UniformName name, const glm::vec3& value) const;
+    void setMat4(UniformName name, const glm::mat4& mat) const;
+
+    void setBool(UniformHandle uniform, bool      value) const;
+    void setInt(UniformHandle uniform, int       value) const;
+    void setFloat(UniformHandle uniform, float    value) const;
+    void setVec3(UniformHandle uniform, const glm::vec3& value) const;
+    void setMat4(UniformHandle uniform, const glm::mat4& mat) const;
+
+    // glGetUniformLocation calls made by every Shader so far; only reflection after linking makes them
+    static std::size_t locationQueries();
+
+private:
+    std::unordered_map<std::uint32_t, GLint> uniforms;  // name hash -> location
+
+    void reflectUniforms();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,54 @@
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+
+#include <glad/glad.h>
+
+// looks up ARB_buffer_storage; without it StreamBuffer maps each allocation unsynchronized
+bool loadBufferStorage(GLADloadproc load);
+
+// a piece of the current frame region, write `size` bytes to ptr and then commit it
+struct StreamAllocation {
+    void*      ptr = nullptr;
+    GLuint     buffer = 0;
+    GLintptr   offset = 0;
+    GLsizeiptr size = 0;
+};
+
+// Per-frame transient buffer for vertex / uniform data that is rewritten every frame.
+// The buffer is split into `frames` regions; a region is reused only after the fence
+// placed at the end of the frame that last wrote it has signaled, so writes never
+// need driver-side orphaning or synchronization.
+class StreamBuffer {
+public:
+    StreamBuffer(GLsizeiptr frameSize, int frames = 3);
+    ~StreamBuffer();
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    // moves to the next region, waiting for the GPU if it is still reading it
+    void beginFrame();
+    // fences the region written this frame
+    void endFrame();
+
+    // suballocates from the current region; ptr is null when the region is exhausted or size is 0.
+    // alignment need not be a power of two (e.g. sizeof(glm::vec3) so offset / stride is a vertex index).
+    // Without persistent mapping only one allocation can be open at a time: commit it before the next one.
+    StreamAllocation allocate(GLsizeiptr size, GLsizeiptr alignment = 16);
+    // makes the written bytes visible to the GPU (unmaps unless the buffer is persistently mapped)
+    void commit(const StreamAllocation& allocation);
+
+    GLuint buffer() const { return id; }
+    bool persistent() const { return mapped != nullptr; }
+    unsigned int stalls() const { return stallCount; }  // frames that had to wait on a fence
+
+private:
+    GLuint id = 0;
+    GLsizeiptr frameSize;
+    int frames, region = 0;
+    GLsizeiptr head = 0;         // bytes used in the current region
+    GLsync fences[8] = {};
+    char* mapped = nullptr;      // persistent mapping of the whole buffer
+    unsigned int stallCount = 0;
+};
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef VERTEX_FORMAT_H
+#define VERTEX_FORMAT_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <learnopengl/shader.h>
+
+#include <cstddef>
+#include <initializer_list>
+#include <vector>
+
+struct Vertex;
+
+// vertex attributes by shader location: 0 position, 1 normal, 2 texCoords, 3 tangent, 4 bitangent, 5+6 bone ids/weights
+enum VertexAttributeBits : unsigned int {
+    VERTEX_POSITION  = 1u << 0,
+    VERTEX_NORMAL    = 1u << 1,
+    VERTEX_TEXCOORDS = 1u << 2,
+    VERTEX_TANGENT   = 1u << 3,
+    VERTEX_BITANGENT = 1u << 4,
+    VERTEX_BONES     = 1u << 5,
+    VERTEX_ALL       = (1u << 6) - 1
+};
+
+// What a model should upload. The default reproduces the full 88 byte Vertex.
+struct VertexFormat {
+    unsigned int attributes = VERTEX_ALL;
+    // positions as 16-bit unorm relative to the mesh AABB, normals/tangents as 10:10:10:2 snorm,
+    // texCoords as half floats, bone ids as 16-bit and weights as 8-bit unorm
+    bool quantize = false;
+
+    // attributes read by any of the (linked) programs, by their bound locations
+    static VertexFormat consumedBy(std::initializer_list<const Shader*> programs, bool quantize = false);
+};
+
+// format resolved for one mesh: requested attributes that the importer actually provided
+struct VertexLayout {
+    unsigned int attributes = VERTEX_ALL;
+    bool quantized = false;
+    unsigned int stride = 0;
+    unsigned int offsets[7] = {};
+    // shader-side dequantization: position = positionOffset + aPos * positionScale
+    glm::vec3 positionOffset = glm::vec3(0.0f);
+    glm::vec3 positionScale = glm::vec3(1.0f);
+
+    // true when the Vertex array can be uploaded as is
+    bool isFullVertex() const { return attributes == VERTEX_ALL && !quantized; }
+};
+
+VertexLayout makeVertexLayout(const VertexFormat& format, unsigned int available,
+                              const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+// converts vertices into the layout's interleaved bytes
+void packVertices(const VertexLayout& layout, const Vertex* vertices, std::size_t count, std::vector<unsigned char>& out);
+// sets the attribute pointers of the bound VAO for the buffer bound to GL_ARRAY_BUFFER at baseOffset
+void setVertexAttributes(const VertexLayout& layout, std::size_t baseOffset = 0);
+
+#endif
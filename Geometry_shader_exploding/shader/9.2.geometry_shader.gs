@@ -4,15 +4,16 @@ layout (triangle_strip, max_vertices=3) out;
 
 in VS_OUT {
     vec2 texCoords;
+    vec4 tint;
+    float explosionTime;
 } gs_in[];
 out vec2 TexCoords;
-
-uniform float explosionTime;
+out vec4 Tint;
 
 vec4 explode(vec4 p, vec3 n) {
     float speed = 6.0;
-    // move along normal steadily
-    return p + vec4(n * explosionTime * speed, 0.0);
+    // move along normal steadily; every vertex of a triangle belongs to the same instance
+    return p + vec4(n * gs_in[0].explosionTime * speed, 0.0);
 }
 
 vec3 getNormal() {
@@ -26,6 +27,7 @@ void main() {
     for (int i = 0; i < 3; ++i) {
         gl_Position = explode(gl_in[i].gl_Position, normal);
         TexCoords   = gs_in[i].texCoords;
+        Tint        = gs_in[i].tint;
         EmitVertex();
     }
     EndPrimitive();
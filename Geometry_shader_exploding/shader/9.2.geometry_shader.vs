@@ -2,16 +2,34 @@
 layout (location=0) in vec3 aPos;
 layout (location=1) in vec3 aNormal;
 layout (location=2) in vec2 aTexCoords;
+// per instance (instancing.h): placement, tint and explosion start
+layout (location=8) in mat4 aInstanceModel;
+layout (location=12) in vec4 aInstanceTint;
+layout (location=13) in vec4 aInstanceParams;
 
 out VS_OUT {
     vec2 texCoords;
+    vec4 tint;
+    float explosionTime;
 } vs_out;
 
+// per-frame camera data shared by every program (FrameData in frame_data.h)
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 cameraPosition;
+    float time;
+    float deltaTime;
+};
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+uniform vec3 positionOffset;
+uniform vec3 positionScale;
 
 void main() {
     vs_out.texCoords = aTexCoords;
-    gl_Position = projection * view * model * vec4(aPos,1.0);
+    vs_out.tint = aInstanceTint;
+    vs_out.explosionTime = time - aInstanceParams.x;
+    vec3 pos = positionOffset + aPos * positionScale;
+    gl_Position = viewProjection * model * aInstanceModel * vec4(pos,1.0);
 }
\ No newline at end of file
@@ -2,10 +2,11 @@
 out vec4 FragColor;
 
 in vec2 TexCoords;
+in vec4 Tint;
 
-uniform sampler2D texture1;
+uniform sampler2D texture_diffuse1;
 
 void main()
 {
-    FragColor = texture(texture1, TexCoords);
+    FragColor = texture(texture_diffuse1, TexCoords) * Tint;
 }
@@ -1,15 +1,31 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec2 aTexCoords;
+layout (location = 2) in vec2 aTexCoords;
+// per instance (instancing.h); identity / white for non-instanced draws
+layout (location = 8) in mat4 aInstanceModel;
+layout (location = 12) in vec4 aInstanceTint;
 
 out vec2 TexCoords;
+out vec4 Tint;
 
+// per-frame camera data shared by every program (FrameData in frame_data.h)
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 cameraPosition;
+    float time;
+    float deltaTime;
+};
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+// AABB dequantization of 16-bit positions (offset 0 / scale 1 for float positions)
+uniform vec3 positionOffset;
+uniform vec3 positionScale;
 
 void main()
 {
     TexCoords = aTexCoords;
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    Tint = aInstanceTint;
+    vec3 pos = positionOffset + aPos * positionScale;
+    gl_Position = viewProjection * model * aInstanceModel * vec4(pos, 1.0);
 }
@@ -0,0 +1,25 @@
+#version 330 core
+// draws the debris buffers (debris.h) as they are, already in world space
+layout (location=0) in vec3 aCenter;
+layout (location=1) in vec3 aCorner;
+layout (location=5) in vec2 aTexCoords;
+layout (location=6) in vec4 aTint;
+
+out vec2 TexCoords;
+out vec4 Tint;
+
+// per-frame camera data shared by every program (FrameData in frame_data.h)
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 cameraPosition;
+    float time;
+    float deltaTime;
+};
+
+void main() {
+    TexCoords = aTexCoords;
+    Tint = aTint;
+    gl_Position = viewProjection * vec4(aCenter + aCorner, 1.0);
+}
@@ -0,0 +1,43 @@
+#version 330 core
+// Captures an ExplodeVertex mesh (explode_mesh.h) into the debris buffers (debris.h) at detonation:
+// every face starts where explode.vs shows it at time zero and leaves along its normal, as it does there.
+layout (location=0) in vec3 aPos;
+layout (location=1) in vec3 aFaceNormal;
+layout (location=2) in vec2 aTexCoords;
+layout (location=3) in vec3 aFaceCentroid;
+layout (location=4) in float aSeed;
+layout (location=6) in vec3 aNextCorner;
+// per instance (instancing.h): placement and tint
+layout (location=8) in mat4 aInstanceModel;
+layout (location=12) in vec4 aInstanceTint;
+
+// captured with transform feedback, DebrisVertex order
+out vec3 outCenter;
+out vec3 outCorner;
+out vec3 outNextCorner;
+out vec3 outVelocity;
+out vec3 outSpin;
+out vec2 outTexCoords;
+out vec4 outTint;
+out float outRest;
+
+uniform mat4 model;
+
+void main() {
+    mat4 world = model * aInstanceModel;
+    vec3 normal = mat3(world) * aFaceNormal;
+    normal = dot(normal, normal) > 0.0 ? normalize(normal) : vec3(0.0, 1.0, 0.0);
+    outCenter = vec3(world * vec4(aFaceCentroid, 1.0));
+    outCorner = vec3(world * vec4(aPos, 1.0)) - outCenter;
+    outNextCorner = vec3(world * vec4(aNextCorner, 1.0)) - outCenter;
+    // around explode.vs's 6 units per second, varied per face, with a kick upwards so the debris arcs before it falls
+    outVelocity = normal * 6.0 * (1.0 - 0.25 * aSeed) + vec3(0.0, 2.0 + 2.0 * aSeed, 0.0);
+    // tumble axis from the face seed, the same for all three corners
+    vec3 axis = vec3(fract(aSeed * 7.13), fract(aSeed * 3.71), fract(aSeed * 5.37)) - 0.5;
+    axis = dot(axis, axis) > 1e-6 ? normalize(axis) : vec3(0.0, 1.0, 0.0);
+    outSpin = axis * (4.0 + 8.0 * aSeed);
+    outTexCoords = aTexCoords;
+    outTint = aInstanceTint;
+    outRest = 0.0;
+    gl_Position = vec4(0.0);
+}
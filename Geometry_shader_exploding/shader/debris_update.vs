@@ -0,0 +1,78 @@
+#version 330 core
+// One step of the debris simulation (debris.h), run as a transform feedback pass over DebrisVertex.
+// All three corners of a face read the same center, velocity and spin, so they stay one rigid triangle.
+layout (location=0) in vec3 aCenter;
+layout (location=1) in vec3 aCorner;
+layout (location=2) in vec3 aNextCorner;
+layout (location=3) in vec3 aVelocity;
+layout (location=4) in vec3 aSpin;
+layout (location=5) in vec2 aTexCoords;
+layout (location=6) in vec4 aTint;
+layout (location=7) in float aRest;
+
+// captured with transform feedback into the other debris buffer
+out vec3 outCenter;
+out vec3 outCorner;
+out vec3 outNextCorner;
+out vec3 outVelocity;
+out vec3 outSpin;
+out vec2 outTexCoords;
+out vec4 outTint;
+out float outRest;
+
+uniform float deltaTime;
+uniform float floorY;
+
+const float GRAVITY = 9.8;
+const float RESTITUTION = 0.3;     // vertical speed kept by a bounce
+const float MIN_BOUNCE = 0.5;      // slower landings stick
+const float FLOOR_DAMPING = 4.0;   // per second, sliding and spinning on the floor
+const float SLEEP_SPEED = 0.05;
+const float SLEEP_SECONDS = 0.5;   // at rest this long, a face stops moving
+
+// v rotated by angle around the unit axis (Rodrigues)
+vec3 rotate(vec3 v, vec3 axis, float angle) {
+    float c = cos(angle), s = sin(angle);
+    return v * c + cross(axis, v) * s + axis * dot(axis, v) * (1.0 - c);
+}
+
+void main() {
+    outTexCoords = aTexCoords;
+    outTint = aTint;
+    if (aRest >= SLEEP_SECONDS) {
+        // asleep, copied through untouched
+        outCenter = aCenter;
+        outCorner = aCorner;
+        outNextCorner = aNextCorner;
+        outVelocity = aVelocity;
+        outSpin = aSpin;
+        outRest = aRest;
+        return;
+    }
+
+    vec3 velocity = aVelocity - vec3(0.0, GRAVITY * deltaTime, 0.0);
+    vec3 center = aCenter + velocity * deltaTime;
+    vec3 spin = aSpin;
+    float speed = length(spin);
+    vec3 corner = speed > 0.0 ? rotate(aCorner, spin / speed, speed * deltaTime) : aCorner;
+    vec3 nextCorner = speed > 0.0 ? rotate(aNextCorner, spin / speed, speed * deltaTime) : aNextCorner;
+    // the face touches the floor with its lowest corner; the third corner is minus the other two
+    float lowest = min(min(corner.y, nextCorner.y), -(corner.y + nextCorner.y));
+    float rest = 0.0;
+    if (center.y + lowest <= floorY) {
+        center.y = floorY - lowest;
+        velocity.y = velocity.y < -MIN_BOUNCE ? -velocity.y * RESTITUTION : 0.0;
+        float damping = exp(-FLOOR_DAMPING * deltaTime);
+        velocity.xz *= damping;
+        spin *= damping;
+        if (length(velocity) < SLEEP_SPEED)
+            rest = aRest + deltaTime;
+    }
+
+    outCorner = corner;
+    outNextCorner = nextCorner;
+    outCenter = center;
+    outVelocity = rest > 0.0 ? vec3(0.0) : velocity;
+    outSpin = spin;
+    outRest = rest;
+}
@@ -0,0 +1,53 @@
+#version 330 core
+// Plays back a baked destruction (destruction.h): every vertex follows the rigid transform of its
+// fragment, read from the bake texture and interpolated between the two nearest frames.
+layout (location=0) in vec3 aPos;
+layout (location=2) in vec2 aTexCoords;
+layout (location=5) in float aFragment;
+// per instance (instancing.h): placement, tint and explosion start
+layout (location=8) in mat4 aInstanceModel;
+layout (location=12) in vec4 aInstanceTint;
+layout (location=13) in vec4 aInstanceParams;
+
+out vec2 TexCoords;
+out vec4 Tint;
+
+// per-frame camera data shared by every program (FrameData in frame_data.h)
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 cameraPosition;
+    float time;
+    float deltaTime;
+};
+uniform mat4 model;
+// row per frame: rotation quaternion, translation per fragment
+uniform sampler2D destructionFrames;
+uniform float destructionFps;
+
+vec3 rotate(vec4 q, vec3 v) {
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+void main() {
+    TexCoords = aTexCoords;
+    Tint = aInstanceTint;
+
+    // holds the last (settled) frame once the bake has played
+    int frames = textureSize(destructionFrames, 0).y;
+    float frame = min(max(time - aInstanceParams.x, 0.0) * destructionFps, float(frames - 1));
+    int f0 = int(frame);
+    int f1 = min(f0 + 1, frames - 1);
+    float blend = frame - float(f0);
+
+    int x = int(aFragment + 0.5) * 2;
+    vec4 q0 = texelFetch(destructionFrames, ivec2(x, f0), 0);
+    vec4 q1 = texelFetch(destructionFrames, ivec2(x, f1), 0);
+    q1 = dot(q0, q1) < 0.0 ? -q1 : q1;
+    vec4 q = normalize(mix(q0, q1, blend));
+    vec3 t = mix(texelFetch(destructionFrames, ivec2(x + 1, f0), 0).xyz,
+                 texelFetch(destructionFrames, ivec2(x + 1, f1), 0).xyz, blend);
+
+    gl_Position = viewProjection * model * aInstanceModel * vec4(rotate(q, aPos) + t, 1.0);
+}
@@ -0,0 +1,39 @@
+#version 330 core
+// Vertex-shader-only explosion of an ExplodeVertex mesh (explode_mesh.h): every face is pushed along
+// its precomputed normal at the geometry shader path's 6 units per second, no geometry shader needed.
+// The motion matches that path (no shrink, one speed for every face), so their GPU times compare the
+// same workload; only the normal differs: the geometry shader takes it from the clip-space triangle.
+layout (location=0) in vec3 aPos;
+layout (location=1) in vec3 aFaceNormal;
+layout (location=2) in vec2 aTexCoords;
+// locations 3 (face centroid) and 4 (seed) are there too, the explosion does not need them
+// per instance (instancing.h): placement, tint and explosion start
+layout (location=8) in mat4 aInstanceModel;
+layout (location=12) in vec4 aInstanceTint;
+layout (location=13) in vec4 aInstanceParams;
+
+out vec2 TexCoords;
+out vec4 Tint;
+
+// per-frame camera data shared by every program (FrameData in frame_data.h)
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 cameraPosition;
+    float time;
+    float deltaTime;
+};
+uniform mat4 model;
+
+void main() {
+    TexCoords = aTexCoords;
+    Tint = aInstanceTint;
+
+    mat4 world = model * aInstanceModel;
+    float t = max(time - aInstanceParams.x, 0.0);
+    vec3 normal = mat3(world) * aFaceNormal;
+    normal = dot(normal, normal) > 0.0 ? normalize(normal) : normal;  // degenerate faces stay put
+    float speed = 6.0;
+    gl_Position = viewProjection * (world * vec4(aPos, 1.0) + vec4(normal * speed * t, 0.0));
+}
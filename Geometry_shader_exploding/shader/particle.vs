@@ -1,12 +1,19 @@
 #version 330 core
 layout(location = 0) in vec3 aPos;
 
-uniform mat4 view;
-uniform mat4 projection;
+// per-frame camera data shared by every program (FrameData in frame_data.h)
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 cameraPosition;
+    float time;
+    float deltaTime;
+};
 uniform float pointSize;
 
 void main()
 {
-    gl_Position = projection * view * vec4(aPos, 1.0);
+    gl_Position = viewProjection * vec4(aPos, 1.0);
     gl_PointSize = pointSize;
 }
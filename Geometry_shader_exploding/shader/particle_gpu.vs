@@ -0,0 +1,23 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 2) in float aLife;
+
+// per-frame camera data shared by every program (FrameData in frame_data.h)
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 cameraPosition;
+    float time;
+    float deltaTime;
+};
+uniform float pointSize;
+
+void main()
+{
+    gl_Position = viewProjection * vec4(aPos, 1.0);
+    gl_PointSize = pointSize;
+    // dead particles are moved outside the clip volume
+    if (aLife <= 0.0)
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+}
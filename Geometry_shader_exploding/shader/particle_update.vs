@@ -0,0 +1,26 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aVelocity;
+layout (location = 2) in float aLife;
+
+// captured with transform feedback into the other particle buffer
+out vec3 outPos;
+out vec3 outVelocity;
+out float outLife;
+
+uniform float deltaTime;
+uniform vec3 gravity;
+
+void main()
+{
+    if (aLife <= 0.0) {
+        // dead particles are copied through untouched
+        outPos = aPos;
+        outVelocity = aVelocity;
+        outLife = aLife;
+        return;
+    }
+    outLife = aLife - deltaTime;
+    outVelocity = aVelocity + gravity * deltaTime;
+    outPos = aPos + outVelocity * deltaTime;
+}
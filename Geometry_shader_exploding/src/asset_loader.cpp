@@ -0,0 +1,242 @@
+#include <learnopengl/asset_loader.h>
+#include <learnopengl/mesh_cache.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+static float millisSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+AssetLoader::AssetLoader(AssetManager& assets, unsigned int threads) : assets(assets) {
+    if (threads == 0) {
+        unsigned int hardware = std::thread::hardware_concurrency();  // 0 when unknown
+        threads = hardware > 1 ? hardware - 1 : 1;
+    }
+    for (unsigned int i = 0; i < threads; i++)
+        workers.emplace_back(&AssetLoader::workerLoop, this);
+}
+
+AssetLoader::~AssetLoader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers)
+        worker.join();
+}
+
+std::shared_ptr<const AssetLoader::ModelRequest> AssetLoader::requestModel(const std::string& path, ModelLoadOptions options) {
+    assets.counters.modelRequests++;
+    options.assets = &assets;
+    std::string key = AssetManager::modelKey(path, options);
+    auto inFlight = modelsInFlight.find(key);
+    if (inFlight != modelsInFlight.end())
+        return inFlight->second;
+
+    auto request = std::make_shared<ModelRequest>();
+    request->path = path;
+    if ((request->asset = assets.lookupModel(path, options, 0)))
+        return request;
+
+    modelsInFlight.emplace(key, request);
+    std::unique_ptr<Job> job(new Job());
+    job->model = request;
+    job->key = key;
+    job->path = path;
+    job->options = options;
+    submit(std::move(job));
+    return request;
+}
+
+std::shared_ptr<const AssetLoader::TextureRequest> AssetLoader::requestTexture(const std::string& path, const std::string& directory) {
+    assets.counters.textureRequests++;
+    std::string file = directory + '/' + path;
+    std::string key = canonicalPath(file);
+    auto inFlight = texturesInFlight.find(key);
+    if (inFlight != texturesInFlight.end())
+        return inFlight->second;
+
+    auto request = std::make_shared<TextureRequest>();
+    request->path = file;
+    if ((request->asset = assets.lookupTexture(file, 0)))
+        return request;
+
+    texturesInFlight.emplace(key, request);
+    std::unique_ptr<Job> job(new Job());
+    job->texture = request;
+    job->key = key;
+    job->path = file;
+    submit(std::move(job));
+    return request;
+}
+
+void AssetLoader::submit(std::unique_ptr<Job> job) {
+    job->start = std::chrono::steady_clock::now();
+    if (idle())
+        firstRequest = job->start;
+    requestCount++;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(std::move(job));
+    }
+    wake.notify_one();
+}
+
+void AssetLoader::workerLoop() {
+    for (;;) {
+        std::unique_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this]() { return stopping || !pending.empty(); });
+            if (stopping)
+                return;
+            job = std::move(pending.front());
+            pending.pop_front();
+        }
+
+        process(*job);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        finished.push_back(std::move(job));
+    }
+}
+
+// worker thread: everything that does not need the GL context
+void AssetLoader::process(Job& job) {
+    auto decode = [&job](const std::string& file) {
+        Image image;
+        image.file = file;
+        image.contentHash = hashFile(file);
+        image.pixels = decodeImage(file);
+        job.images.push_back(std::move(image));
+    };
+
+    if (job.model) {
+        auto start = std::chrono::steady_clock::now();
+        job.contentHash = hashFile(job.path);
+        job.data = Model::import(job.path, job.options);
+        job.importMillis = millisSince(start);
+
+        // each texture once, even when several meshes share it
+        start = std::chrono::steady_clock::now();
+        for (const MeshData& mesh : job.data.meshes) {
+            for (const TextureRef& ref : mesh.textures) {
+                std::string file = job.data.directory + '/' + ref.path;
+                bool seen = std::any_of(job.images.begin(), job.images.end(),
+                    [&file](const Image& image) { return image.file == file; });
+                if (!seen)
+                    decode(file);
+            }
+        }
+        job.decodeMillis = millisSince(start);
+    }
+    else {
+        auto start = std::chrono::steady_clock::now();
+        decode(job.path);
+        job.decodeMillis = millisSince(start);
+    }
+}
+
+void AssetLoader::update(float budgetMillis) {
+    auto start = std::chrono::steady_clock::now();
+    do {
+        if (!uploading) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (finished.empty())
+                return;
+            uploading = std::move(finished.front());
+            finished.pop_front();
+        }
+
+        Job& job = *uploading;
+        if (job.uploaded < job.images.size()) {
+            auto step = std::chrono::steady_clock::now();
+            uploadImage(job, job.images[job.uploaded++]);
+            job.uploadMillis += millisSince(step);
+        }
+        else {
+            finish(job);
+            uploading.reset();
+        }
+    } while (millisSince(start) < budgetMillis);
+}
+
+// GL thread: one texture per step. The pixels go through the unpack buffer, so glTexImage2D only
+// schedules the transfer instead of copying from client memory before it returns.
+void AssetLoader::uploadImage(Job& job, Image& image) {
+    if (!image.pixels) {
+        // the model picks the fallback up by path instead of decoding again on this thread
+        std::cout << "Texture failed to load at path: " << image.file << std::endl;
+        job.failedImages++;
+        job.textures.push_back(assets.addFailedTexture(image.file));
+        return;
+    }
+    if (AssetManager::TextureHandle texture = assets.lookupTexture(image.file, image.contentHash)) {
+        job.textures.push_back(std::move(texture));
+        return;
+    }
+
+    if (!unpackBuffer)
+        unpackBuffer = makeBuffer();
+    GLsizeiptr size = (GLsizeiptr)image.pixels.size();
+    glState().bindBuffer(GL_PIXEL_UNPACK_BUFFER, unpackBuffer);
+    // fresh storage every upload, so mapping never waits for the previous transfer
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    void* dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    bool staged = false;
+    if (dst) {
+        std::memcpy(dst, image.pixels.pixels, (std::size_t)size);
+        staged = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE;
+    }
+    GLuint name = staged ? TextureFromImage(image.pixels, nullptr) : 0;  // offset 0 into the unpack buffer
+    glState().bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    if (!staged)
+        name = TextureFromImage(image.pixels, image.pixels.pixels);
+
+    job.textures.push_back(assets.addTexture(image.file, image.contentHash, GLTexture(name)));
+    image.pixels = DecodedImage();
+}
+
+// GL thread: builds the model from its imported data (its textures are registered by now)
+void AssetLoader::finish(Job& job) {
+    auto start = std::chrono::steady_clock::now();
+    bool failed;
+    float totalMillis = millisSince(job.start);
+    if (job.model) {
+        ModelRequest& request = *job.model;
+        if (job.data.valid) {
+            // the same file may have arrived under another path in the meantime
+            request.asset = assets.lookupModel(job.path, job.options, job.contentHash);
+            if (!request.asset)
+                request.asset = assets.addModel(job.path, job.options, job.contentHash, Model(std::move(job.data), job.options));
+        }
+        job.uploadMillis += millisSince(start);
+        request.failed = failed = !request.asset;
+        request.importMillis = job.importMillis;
+        request.decodeMillis = job.decodeMillis;
+        request.uploadMillis = job.uploadMillis;
+        request.totalMillis = totalMillis = millisSince(job.start);
+        modelsInFlight.erase(job.key);
+    }
+    else {
+        TextureRequest& request = *job.texture;
+        if (!job.textures.empty())
+            request.asset = job.textures.front();
+        request.failed = failed = !request.asset || job.failedImages;
+        request.decodeMillis = job.decodeMillis;
+        request.uploadMillis = job.uploadMillis;
+        request.totalMillis = totalMillis;
+        texturesInFlight.erase(job.key);
+    }
+
+    completeCount++;
+    std::cout << "ASSET_LOADER::" << job.path << (failed ? " failed" : " ready") << " after " << totalMillis
+        << " ms (import " << job.importMillis << " ms, decode " << job.decodeMillis << " ms, upload "
+        << job.uploadMillis << " ms) [" << completeCount << "/" << requestCount << "]" << std::endl;
+    if (idle()) {
+        std::cout << "ASSET_LOADER::" << requestCount << " assets loaded in " << millisSince(firstRequest) << " ms" << std::endl;
+    }
+}
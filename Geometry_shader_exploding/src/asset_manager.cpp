@@ -0,0 +1,156 @@
+#include <learnopengl/asset_manager.h>
+#include <learnopengl/mesh_cache.h>
+
+#include <cctype>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <stdlib.h>
+#else
+#include <climits>
+#endif
+
+std::string canonicalPath(const std::string& path) {
+#ifdef _WIN32
+    char buffer[_MAX_PATH];
+    if (!_fullpath(buffer, path.c_str(), _MAX_PATH))
+        return path;
+    std::string result(buffer);
+    for (char& c : result) {
+        if (c == '\\') c = '/';
+        else c = (char)std::tolower((unsigned char)c);  // NTFS paths are case-insensitive
+    }
+    return result;
+#else
+    char buffer[PATH_MAX];
+    if (!realpath(path.c_str(), buffer))
+        return path;
+    return std::string(buffer);
+#endif
+}
+
+// live asset registered under key, or null
+template <class Map>
+static auto lookup(const Map& map, const typename Map::key_type& key) -> decltype(map.begin()->second.lock()) {
+    auto it = map.find(key);
+    if (it == map.end())
+        return nullptr;
+    return it->second.lock();
+}
+
+// model content depends on the load options too, e.g. a quantized and a float copy are different assets
+static std::string optionsKey(const ModelLoadOptions& options) {
+    return "|" + std::to_string(options.format.attributes) + "|" + std::to_string(options.format.quantize)
+        + "|" + std::to_string(options.optimize) + "|" + std::to_string(options.generateLods)
+        + "|" + std::to_string(options.explodable);
+}
+
+std::string AssetManager::modelKey(const std::string& path, const ModelLoadOptions& options) {
+    return canonicalPath(path) + optionsKey(options);
+}
+
+AssetManager::ModelHandle AssetManager::lookupModel(const std::string& path, const ModelLoadOptions& options,
+                                                    std::uint64_t contentHash) {
+    std::string pathKey = modelKey(path, options);
+    if (ModelHandle model = lookup(modelsByPath, pathKey))
+        return model;
+    if (contentHash == 0)
+        return nullptr;
+
+    ModelHandle model = lookup(modelsByContent, std::to_string(contentHash) + optionsKey(options));
+    if (model)
+        modelsByPath[pathKey] = model;
+    return model;
+}
+
+AssetManager::ModelHandle AssetManager::addModel(const std::string& path, const ModelLoadOptions& options,
+                                                 std::uint64_t contentHash, Model model) {
+    counters.modelLoads++;
+    ModelHandle handle = std::make_shared<Model>(std::move(model));
+    modelsByPath[modelKey(path, options)] = handle;
+    modelsByContent[std::to_string(contentHash) + optionsKey(options)] = handle;
+    return handle;
+}
+
+AssetManager::ModelHandle AssetManager::loadModel(const std::string& path, ModelLoadOptions options) {
+    counters.modelRequests++;
+    if (ModelHandle model = lookupModel(path, options, 0))
+        return model;
+
+    std::uint64_t contentHash = hashFile(path);
+    if (ModelHandle model = lookupModel(path, options, contentHash))
+        return model;
+
+    options.assets = this;
+    return addModel(path, options, contentHash, Model(path, options));
+}
+
+AssetManager::TextureHandle AssetManager::lookupTexture(const std::string& file, std::uint64_t contentHash) {
+    std::string pathKey = canonicalPath(file);
+    if (TextureHandle texture = lookup(texturesByPath, pathKey))
+        return texture;
+    if (contentHash == 0)
+        return nullptr;
+
+    TextureHandle texture = lookup(texturesByContent, contentHash);
+    if (texture)
+        texturesByPath[pathKey] = texture;
+    return texture;
+}
+
+AssetManager::TextureHandle AssetManager::addTexture(const std::string& file, std::uint64_t contentHash, GLTexture texture) {
+    counters.textureLoads++;
+    TextureHandle handle = std::make_shared<GLTexture>(std::move(texture));
+    texturesByPath[canonicalPath(file)] = handle;
+    if (contentHash != 0)
+        texturesByContent[contentHash] = handle;
+    return handle;
+}
+
+AssetManager::TextureHandle AssetManager::addFailedTexture(const std::string& file) {
+    TextureHandle handle = fallback.lock();
+    if (!handle) {
+        static const unsigned char white[4] = { 255, 255, 255, 255 };
+        DecodedImage image;
+        image.width = image.height = 1;
+        image.channels = 4;
+        handle = std::make_shared<GLTexture>(TextureFromImage(image, white));
+        fallback = handle;
+    }
+    texturesByPath[canonicalPath(file)] = handle;
+    return handle;
+}
+
+AssetManager::TextureHandle AssetManager::loadTexture(const std::string& path, const std::string& directory) {
+    std::string file = directory + '/' + path;
+    counters.textureRequests++;
+    if (TextureHandle texture = lookupTexture(file, 0))
+        return texture;
+
+    std::uint64_t contentHash = hashFile(file);
+    if (TextureHandle texture = lookupTexture(file, contentHash))
+        return texture;
+
+    return addTexture(file, contentHash, GLTexture(TextureFromFile(path.c_str(), directory)));
+}
+
+AssetManager::MeshHandle AssetManager::meshOf(const ModelHandle& model, std::size_t index) {
+    return MeshHandle(model, &model->getRanges()[index]);
+}
+
+template <class Map>
+static void eraseExpired(Map& map) {
+    for (auto it = map.begin(); it != map.end();) {
+        if (it->second.expired())
+            it = map.erase(it);
+        else
+            ++it;
+    }
+}
+
+void AssetManager::collect() {
+    eraseExpired(modelsByPath);
+    eraseExpired(modelsByContent);
+    eraseExpired(texturesByPath);
+    eraseExpired(texturesByContent);
+}
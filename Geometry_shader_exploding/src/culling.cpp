@@ -0,0 +1,110 @@
+#include <learnopengl/culling.h>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CULLING_SSE
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define CULLING_NEON
+#endif
+
+Frustum extractFrustum(const glm::mat4& m) {
+    // rows of the matrix (glm is column-major: m[column][row])
+    glm::vec4 row[4];
+    for (int r = 0; r < 4; r++)
+        row[r] = glm::vec4(m[0][r], m[1][r], m[2][r], m[3][r]);
+
+    Frustum frustum;
+    frustum.planes[0] = row[3] + row[0];
+    frustum.planes[1] = row[3] - row[0];
+    frustum.planes[2] = row[3] + row[1];
+    frustum.planes[3] = row[3] - row[1];
+    frustum.planes[4] = row[3] + row[2];
+    frustum.planes[5] = row[3] - row[2];
+    for (glm::vec4& plane : frustum.planes)
+        plane /= glm::length(glm::vec3(plane));
+    return frustum;
+}
+
+BoundingSphere transformSphere(const BoundingSphere& sphere, const glm::mat4& transform) {
+    float scale = std::sqrt(std::max(glm::dot(glm::vec3(transform[0]), glm::vec3(transform[0])),
+        std::max(glm::dot(glm::vec3(transform[1]), glm::vec3(transform[1])),
+                 glm::dot(glm::vec3(transform[2]), glm::vec3(transform[2])))));
+    return BoundingSphere{ glm::vec3(transform * glm::vec4(sphere.center, 1.0f)), sphere.radius * scale };
+}
+
+void CullingBatch::clear() {
+    x.clear(); y.clear(); z.clear(); radius.clear();
+    visibleFlags.clear();
+    stats_ = CullingStats();
+}
+
+std::size_t CullingBatch::add(const BoundingSphere& sphere) {
+    x.push_back(sphere.center.x);
+    y.push_back(sphere.center.y);
+    z.push_back(sphere.center.z);
+    radius.push_back(sphere.radius);
+    visibleFlags.push_back(1);
+    return x.size() - 1;
+}
+
+void CullingBatch::cull(const Frustum& frustum) {
+    const std::size_t n = x.size();
+    std::size_t i = 0;
+
+    // a sphere is outside once it lies entirely behind any plane: dot(normal, center) + distance < -radius
+#if defined(CULLING_SSE)
+    for (; i + CULLING_LANES <= n; i += CULLING_LANES) {
+        __m128 cx = _mm_loadu_ps(&x[i]), cy = _mm_loadu_ps(&y[i]), cz = _mm_loadu_ps(&z[i]);
+        __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&radius[i]));
+        __m128 outside = _mm_setzero_ps();
+        for (const glm::vec4& plane : frustum.planes) {
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(plane.x)), _mm_mul_ps(cy, _mm_set1_ps(plane.y))),
+                                  _mm_add_ps(_mm_mul_ps(cz, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w)));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(d, negRadius));
+        }
+        int mask = _mm_movemask_ps(outside);
+        for (std::size_t k = 0; k < CULLING_LANES; k++)
+            visibleFlags[i + k] = (mask >> k & 1) ? 0 : 1;
+    }
+#elif defined(CULLING_NEON)
+    for (; i + CULLING_LANES <= n; i += CULLING_LANES) {
+        float32x4_t cx = vld1q_f32(&x[i]), cy = vld1q_f32(&y[i]), cz = vld1q_f32(&z[i]);
+        float32x4_t negRadius = vnegq_f32(vld1q_f32(&radius[i]));
+        uint32x4_t outside = vdupq_n_u32(0);
+        for (const glm::vec4& plane : frustum.planes) {
+            float32x4_t d = vaddq_f32(vaddq_f32(vmulq_n_f32(cx, plane.x), vmulq_n_f32(cy, plane.y)),
+                                      vaddq_f32(vmulq_n_f32(cz, plane.z), vdupq_n_f32(plane.w)));
+            outside = vorrq_u32(outside, vcltq_f32(d, negRadius));
+        }
+        std::uint32_t lanes[CULLING_LANES];
+        vst1q_u32(lanes, outside);
+        for (std::size_t k = 0; k < CULLING_LANES; k++)
+            visibleFlags[i + k] = lanes[k] ? 0 : 1;
+    }
+#endif
+
+    // remainder (or everything, when no SIMD instruction set is available)
+    for (; i < n; i++) {
+        bool outside = false;
+        for (const glm::vec4& plane : frustum.planes)
+            outside = outside || plane.x * x[i] + plane.y * y[i] + plane.z * z[i] + plane.w < -radius[i];
+        visibleFlags[i] = outside ? 0 : 1;
+    }
+
+    stats_.visible = (std::size_t)std::count(visibleFlags.begin(), visibleFlags.end(), 1);
+    stats_.culled = n - stats_.visible;
+}
+
+const char* cullingSimdName() {
+#if defined(CULLING_SSE)
+    return "SSE2";
+#elif defined(CULLING_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,205 @@
+#include <learnopengl/debris.h>
+#include <learnopengl/gl_state.h>
+
+#include <algorithm>
+#include <cstddef>
+
+// outputs of both the capture and the update program, interleaved in DebrisVertex order
+static const char* DEBRIS_VARYINGS[] = {
+    "outCenter", "outCorner", "outNextCorner", "outVelocity", "outSpin", "outTexCoords", "outTint", "outRest"
+};
+static const int DEBRIS_VARYING_COUNT = 8;
+
+DebrisField::DebrisField(std::size_t ringWrecks, float floorY, const char* captureShaderPath, const char* updateShaderPath)
+    : captureProgram(captureShaderPath, DEBRIS_VARYINGS, DEBRIS_VARYING_COUNT),
+      updateProgram(updateShaderPath, DEBRIS_VARYINGS, DEBRIS_VARYING_COUNT),
+      ringWrecks(ringWrecks) {
+    // the attribute pointers name the buffers, which keep them across allocate()
+    const GLsizei stride = sizeof(DebrisVertex);
+    for (int i = 0; i < 2; i++) {
+        vbo[i] = makeBuffer();
+        vao[i] = makeVertexArray();
+        glState().bindVertexArray(vao[i]);
+        glState().bindBuffer(GL_ARRAY_BUFFER, vbo[i]);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(DebrisVertex, center));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(DebrisVertex, corner));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(DebrisVertex, nextCorner));
+        glEnableVertexAttribArray(3);
+        glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(DebrisVertex, velocity));
+        glEnableVertexAttribArray(4);
+        glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(DebrisVertex, spin));
+        glEnableVertexAttribArray(5);
+        glVertexAttribPointer(5, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(DebrisVertex, texCoords));
+        glEnableVertexAttribArray(6);
+        glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(DebrisVertex, tint));
+        glEnableVertexAttribArray(7);
+        glVertexAttribPointer(7, 1, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(DebrisVertex, rest));
+    }
+    glState().bindVertexArray(0);
+
+    updateProgram.use();
+    updateProgram.setFloat("floorY", floorY);
+    updateDeltaTime = updateProgram.uniform("deltaTime");
+}
+
+DebrisField::~DebrisField() {
+    glState().forgetProgram(captureProgram.ID);
+    glState().forgetProgram(updateProgram.ID);
+    glDeleteProgram(captureProgram.ID);
+    glDeleteProgram(updateProgram.ID);
+}
+
+void DebrisField::allocate(std::size_t vertices) {
+    for (int i = 0; i < 2; i++) {
+        glState().bindBuffer(GL_ARRAY_BUFFER, vbo[i]);
+        glBufferData(GL_ARRAY_BUFFER, vertices * sizeof(DebrisVertex), nullptr, GL_DYNAMIC_COPY);
+    }
+    capacity_ = vertices;
+    cursor = 0;
+}
+
+bool DebrisField::reserveWreck(std::size_t vertexCount) {
+    if (vertexCount == 0)
+        return false;
+    if (vertexCount > capacity_ && wrecks.empty())
+        allocate(ringWrecks * vertexCount);
+    if (vertexCount > capacity_) {
+        droppedCount++;
+        return false;
+    }
+
+    // whatever the new wreck overlaps is recycled whole, so no wreck is ever drawn half overwritten;
+    // a wreck not captured yet keeps its range, or two cars of this frame would share it
+    const std::size_t first = cursor + vertexCount > capacity_ ? 0 : cursor;
+    auto overlaps = [first, vertexCount](const Wreck& w) { return w.first < first + vertexCount && first < w.first + w.count; };
+    if (std::any_of(wrecks.begin(), wrecks.end(), [&overlaps](const Wreck& w) { return !w.captured && overlaps(w); })) {
+        droppedCount++;
+        return false;
+    }
+    std::size_t before = wrecks.size();
+    wrecks.erase(std::remove_if(wrecks.begin(), wrecks.end(), overlaps), wrecks.end());
+    recycledCount += before - wrecks.size();
+    wrecks.push_back(Wreck{ first, vertexCount, 0.0f, false, false });
+    cursor = first + vertexCount;
+    rebuildDrawList();
+    return true;
+}
+
+bool DebrisField::beginCapture() {
+    auto next = std::find_if(wrecks.begin(), wrecks.end(), [](const Wreck& w) { return !w.captured; });
+    if (next == wrecks.end())
+        return false;
+    next->captured = true;
+    capturedCount++;
+
+    captureProgram.use();
+    glState().setEnabled(GL_RASTERIZER_DISCARD, true);
+    glBindBufferRange(GL_TRANSFORM_FEEDBACK_BUFFER, 0, vbo[cur], (GLintptr)(next->first * sizeof(DebrisVertex)),
+        (GLsizeiptr)(next->count * sizeof(DebrisVertex)));
+    glBeginTransformFeedback(GL_TRIANGLES);
+    return true;
+}
+
+void DebrisField::endCapture() {
+    glEndTransformFeedback();
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glState().setEnabled(GL_RASTERIZER_DISCARD, false);
+}
+
+void DebrisField::update(float dt) {
+    std::size_t before = wrecks.size();
+    wrecks.erase(std::remove_if(wrecks.begin(), wrecks.end(), [](const Wreck& w) { return !w.captured; }), wrecks.end());
+    if (wrecks.size() != before)
+        rebuildDrawList();
+    if (settling() == 0)
+        return;
+
+    // Feedback output fills the bound range from its start, so one pass can only cover a contiguous
+    // span. In ring order, a run takes in the settling wrecks and the free space between them (written,
+    // never read) and ends at a settled wreck, whose copy in the other buffer must not change.
+    ringOrder.clear();
+    for (const Wreck& w : wrecks)
+        ringOrder.push_back(&w);
+    std::sort(ringOrder.begin(), ringOrder.end(), [](const Wreck* a, const Wreck* b) { return a->first < b->first; });
+    runs.clear();
+    bool extend = false;
+    for (const Wreck* w : ringOrder) {
+        if (w->settled) {
+            extend = false;
+            continue;
+        }
+        if (extend)
+            runs.back().count = w->first + w->count - runs.back().first;
+        else
+            runs.push_back(Run{ w->first, w->count });
+        extend = true;
+    }
+
+    updateProgram.use();
+    updateProgram.setFloat(updateDeltaTime, dt);
+    glState().setEnabled(GL_RASTERIZER_DISCARD, true);
+    glState().bindVertexArray(vao[cur]);
+    for (const Run& run : runs) {
+        glBindBufferRange(GL_TRANSFORM_FEEDBACK_BUFFER, 0, vbo[1 - cur], (GLintptr)(run.first * sizeof(DebrisVertex)),
+            (GLsizeiptr)(run.count * sizeof(DebrisVertex)));
+        glBeginTransformFeedback(GL_POINTS);
+        glDrawArrays(GL_POINTS, (GLint)run.first, (GLsizei)run.count);
+        glEndTransformFeedback();
+    }
+    updateCount++;
+    passCount += runs.size();
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glState().setEnabled(GL_RASTERIZER_DISCARD, false);
+    cur = 1 - cur;
+
+    // settled wrecks are skipped from now on, so the buffer not written this frame needs their final state too
+    for (Wreck& w : wrecks) {
+        if (w.settled)
+            continue;
+        w.age += dt;
+        if (w.age < DEBRIS_SETTLE_SECONDS)
+            continue;
+        w.settled = true;
+        glState().bindBuffer(GL_COPY_READ_BUFFER, vbo[cur]);
+        glState().bindBuffer(GL_COPY_WRITE_BUFFER, vbo[1 - cur]);
+        GLintptr offset = (GLintptr)(w.first * sizeof(DebrisVertex));
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, offset, offset, (GLsizeiptr)(w.count * sizeof(DebrisVertex)));
+    }
+}
+
+void DebrisField::draw() const {
+    if (wrecks.empty())
+        return;
+    glState().bindVertexArray(vao[cur]);
+    glMultiDrawArrays(GL_TRIANGLES, drawFirst.data(), drawCount.data(), (GLsizei)drawFirst.size());
+}
+
+void DebrisField::clear() {
+    // nothing outside a wreck is ever read, so the buffers keep their contents
+    wrecks.clear();
+    cursor = 0;
+    rebuildDrawList();
+}
+
+std::size_t DebrisField::settling() const {
+    return (std::size_t)std::count_if(wrecks.begin(), wrecks.end(), [](const Wreck& w) { return !w.settled; });
+}
+
+std::size_t DebrisField::liveVertices() const {
+    std::size_t vertices = 0;
+    for (const Wreck& w : wrecks)
+        vertices += w.count;
+    return vertices;
+}
+
+void DebrisField::rebuildDrawList() {
+    drawFirst.clear();
+    drawCount.clear();
+    for (const Wreck& w : wrecks) {
+        drawFirst.push_back((GLint)w.first);
+        drawCount.push_back((GLsizei)w.count);
+    }
+}
@@ -0,0 +1,114 @@
+#include <learnopengl/destruction.h>
+#include <learnopengl/gl_state.h>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <random>
+
+static const float GRAVITY = 9.8f;
+static const float RESTITUTION = 0.3f;      // vertical speed kept by a bounce
+static const float FLOOR_FRICTION = 0.6f;   // horizontal and angular speed kept by a bounce
+static const float ROLLING_DAMPING = 3.0f;  // per second, while resting on the floor
+static const float SLEEP_SPEED = 0.05f;
+// fragments are flat shells, so they settle closer to the floor than their bounding radius
+static const float CONTACT_RADIUS_SCALE = 0.4f;
+
+namespace {
+struct Body {
+    glm::vec3 position;
+    glm::quat orientation;
+    glm::vec3 velocity;
+    glm::vec3 angularVelocity;
+    float contactRadius;
+    bool asleep;
+};
+}
+
+DestructionBake bakeDestruction(const std::vector<DestructionFragment>& fragments, const glm::vec3& origin, float floorY,
+                                std::uint32_t seed) {
+    DestructionBake bake;
+    if (fragments.empty())
+        return bake;
+    bake.fragmentCount = (int)fragments.size();
+    bake.frameCount = DESTRUCTION_BAKE_FRAMES;
+    bake.texels.resize((std::size_t)bake.frameCount * bake.fragmentCount * 2);
+
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f), signedUnit(-1.0f, 1.0f);
+    float lightest = fragments[0].mass;
+    for (const DestructionFragment& f : fragments)
+        lightest = std::min(lightest, f.mass);
+
+    std::vector<Body> bodies(fragments.size());
+    for (std::size_t i = 0; i < fragments.size(); i++) {
+        const DestructionFragment& f = fragments[i];
+        glm::vec3 away = f.center - origin;
+        away.y = std::max(away.y, 0.0f);
+        float length = glm::length(away);
+        glm::vec3 direction = length > 0.0f ? away / length : glm::vec3(0.0f, 1.0f, 0.0f);
+        // heavier pieces are thrown slower and spin less
+        float agility = lightest > 0.0f && f.mass > 0.0f ? std::sqrt(lightest / f.mass) : 1.0f;
+        float speed = (3.0f + 3.0f * unit(random)) * (0.5f + 0.5f * agility);
+        Body& b = bodies[i];
+        b.position = f.center;
+        b.orientation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        b.velocity = direction * speed + glm::vec3(0.0f, 2.0f + 3.0f * unit(random), 0.0f);
+        b.angularVelocity = glm::vec3(signedUnit(random), signedUnit(random), signedUnit(random)) * (6.0f * agility);
+        b.contactRadius = f.radius * CONTACT_RADIUS_SCALE;
+        b.asleep = false;
+    }
+
+    const float dt = 1.0f / (bake.fps * DESTRUCTION_SUBSTEPS);
+    for (int frame = 0; frame < bake.frameCount; frame++) {
+        glm::vec4* row = &bake.texels[(std::size_t)frame * bake.fragmentCount * 2];
+        for (std::size_t i = 0; i < bodies.size(); i++) {
+            const Body& b = bodies[i];
+            glm::vec3 translation = b.position - b.orientation * fragments[i].center;
+            row[2 * i] = glm::vec4(b.orientation.x, b.orientation.y, b.orientation.z, b.orientation.w);
+            row[2 * i + 1] = glm::vec4(translation, 1.0f);
+            bake.reach = std::max(bake.reach, glm::length(b.position - origin) + fragments[i].radius);
+        }
+
+        for (int step = 0; step < DESTRUCTION_SUBSTEPS; step++) {
+            for (Body& b : bodies) {
+                if (b.asleep)
+                    continue;
+                b.velocity.y -= GRAVITY * dt;
+                b.position += b.velocity * dt;
+                glm::quat spin(0.0f, b.angularVelocity.x, b.angularVelocity.y, b.angularVelocity.z);
+                b.orientation = glm::normalize(b.orientation + spin * b.orientation * (0.5f * dt));
+
+                float bottom = floorY + b.contactRadius;
+                if (b.position.y > bottom)
+                    continue;
+                b.position.y = bottom;
+                if (b.velocity.y < 0.0f) {
+                    b.velocity.y = -b.velocity.y * RESTITUTION;
+                    b.velocity.x *= FLOOR_FRICTION;
+                    b.velocity.z *= FLOOR_FRICTION;
+                    b.angularVelocity *= FLOOR_FRICTION;
+                }
+                float damping = std::max(1.0f - ROLLING_DAMPING * dt, 0.0f);
+                b.velocity.x *= damping;
+                b.velocity.z *= damping;
+                b.angularVelocity *= damping;
+                if (glm::length(b.velocity) < SLEEP_SPEED && glm::length(b.angularVelocity) < SLEEP_SPEED)
+                    b.asleep = true;
+            }
+        }
+    }
+    return bake;
+}
+
+GLuint DestructionTextureFromBake(const DestructionBake& bake) {
+    GLuint id;
+    glGenTextures(1, &id);
+    glState().bindTexture(DESTRUCTION_TEXTURE_UNIT, id);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, bake.fragmentCount * 2, bake.frameCount, 0, GL_RGBA, GL_FLOAT, bake.texels.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    return id;
+}
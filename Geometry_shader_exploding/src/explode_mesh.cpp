@@ -0,0 +1,50 @@
+#include <learnopengl/explode_mesh.h>
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+
+// integer hash (lowbias32), so seeds do not depend on a global random state
+static float faceSeed(std::uint32_t face) {
+    face ^= face >> 16;
+    face *= 0x7feb352du;
+    face ^= face >> 15;
+    face *= 0x846ca68bu;
+    face ^= face >> 16;
+    return (face >> 8) * (1.0f / 16777216.0f);
+}
+
+void buildExplodeVertices(const Vertex* vertices, const unsigned int* indices, std::size_t indexCount,
+                          std::vector<ExplodeVertex>& out) {
+    out.reserve(out.size() + indexCount - indexCount % 3);
+    for (std::size_t i = 0; i + 2 < indexCount; i += 3) {
+        const Vertex* corner[3] = { &vertices[indices[i]], &vertices[indices[i + 1]], &vertices[indices[i + 2]] };
+        glm::vec3 normal = glm::cross(corner[1]->Position - corner[0]->Position, corner[2]->Position - corner[0]->Position);
+        float length = glm::length(normal);
+        normal = length > 0.0f ? normal / length : glm::vec3(0.0f);
+        glm::vec3 centroid = (corner[0]->Position + corner[1]->Position + corner[2]->Position) / 3.0f;
+        float seed = faceSeed((std::uint32_t)(i / 3));
+        for (int k = 0; k < 3; k++)
+            out.push_back(ExplodeVertex{ corner[k]->Position, normal, corner[k]->TexCoords, centroid, seed, 0.0f,
+                                         corner[(k + 1) % 3]->Position });
+    }
+}
+
+void setExplodeVertexAttributes() {
+    const GLsizei stride = sizeof(ExplodeVertex);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(ExplodeVertex, position));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(ExplodeVertex, faceNormal));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(ExplodeVertex, texCoords));
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(ExplodeVertex, faceCentroid));
+    glEnableVertexAttribArray(4);
+    glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(ExplodeVertex, seed));
+    glEnableVertexAttribArray(5);
+    glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(ExplodeVertex, fragment));
+    glEnableVertexAttribArray(6);
+    glVertexAttribPointer(6, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(ExplodeVertex, nextCorner));
+}
@@ -0,0 +1,179 @@
+#include <learnopengl/fracture.h>
+#include <learnopengl/mesh_cache.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <random>
+
+static const char FRACTURE_CACHE_MAGIC[8] = "FRACTUR";
+
+Fracture fractureTriangles(const glm::vec3* corners, std::size_t triangleCount, int chunkCount, std::uint32_t seed) {
+    auto start = std::chrono::steady_clock::now();
+    Fracture fracture;
+    const std::size_t k = std::min<std::size_t>((std::size_t)std::max(chunkCount, 1), triangleCount);
+    if (k == 0)
+        return fracture;
+
+    std::vector<glm::vec3> centroid(triangleCount);
+    std::vector<float> area(triangleCount);
+    float totalArea = 0.0f;
+    for (std::size_t t = 0; t < triangleCount; t++) {
+        const glm::vec3* c = corners + 3 * t;
+        centroid[t] = (c[0] + c[1] + c[2]) / 3.0f;
+        area[t] = 0.5f * glm::length(glm::cross(c[1] - c[0], c[2] - c[0]));
+        totalArea += area[t];
+    }
+    // degenerate meshes still get split, by triangle count instead of area
+    auto weight = [&](std::size_t t) { return totalArea > 0.0f ? area[t] : 1.0f; };
+
+    // k-means++: every further center is drawn with probability proportional to weight * squared distance
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<glm::vec3> centers;
+    centers.reserve(k);
+    std::vector<float> nearest(triangleCount, std::numeric_limits<float>::max());
+    {
+        float pick = unit(random) * (totalArea > 0.0f ? totalArea : (float)triangleCount);
+        std::size_t first = 0;
+        while (first + 1 < triangleCount && (pick -= weight(first)) > 0.0f)
+            first++;
+        centers.push_back(centroid[first]);
+    }
+    while (centers.size() < k) {
+        double sum = 0.0;
+        for (std::size_t t = 0; t < triangleCount; t++) {
+            glm::vec3 d = centroid[t] - centers.back();
+            nearest[t] = std::min(nearest[t], glm::dot(d, d));
+            sum += weight(t) * nearest[t];
+        }
+        if (sum <= 0.0)
+            break;  // fewer distinct centroids than chunks
+        double pick = unit(random) * sum;
+        std::size_t next = 0;
+        while (next + 1 < triangleCount && (pick -= weight(next) * nearest[next]) > 0.0)
+            next++;
+        centers.push_back(centroid[next]);
+    }
+
+    // Lloyd iterations
+    std::vector<std::uint16_t>& chunkOf = fracture.chunkOfTriangle;
+    chunkOf.assign(triangleCount, 0);
+    std::vector<glm::vec3> sum(centers.size());
+    std::vector<float> mass(centers.size());
+    for (int iteration = 0; iteration < FRACTURE_ITERATIONS; iteration++) {
+        bool changed = false;
+        for (std::size_t t = 0; t < triangleCount; t++) {
+            std::uint16_t best = 0;
+            float bestDistance = std::numeric_limits<float>::max();
+            for (std::size_t c = 0; c < centers.size(); c++) {
+                glm::vec3 d = centroid[t] - centers[c];
+                float distance = glm::dot(d, d);
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    best = (std::uint16_t)c;
+                }
+            }
+            changed |= iteration == 0 || chunkOf[t] != best;
+            chunkOf[t] = best;
+        }
+        if (!changed)
+            break;
+
+        std::fill(sum.begin(), sum.end(), glm::vec3(0.0f));
+        std::fill(mass.begin(), mass.end(), 0.0f);
+        for (std::size_t t = 0; t < triangleCount; t++) {
+            sum[chunkOf[t]] += centroid[t] * weight(t);
+            mass[chunkOf[t]] += weight(t);
+        }
+        for (std::size_t c = 0; c < centers.size(); c++) {
+            if (mass[c] > 0.0f)
+                centers[c] = sum[c] / mass[c];
+        }
+    }
+
+    // drop chunks that ended up without triangles, renumbering the rest
+    std::vector<std::size_t> triangles(centers.size(), 0);
+    for (std::uint16_t c : chunkOf)
+        triangles[c]++;
+    std::vector<std::uint16_t> renumber(centers.size());
+    for (std::size_t c = 0; c < centers.size(); c++) {
+        renumber[c] = (std::uint16_t)fracture.chunks.size();
+        if (triangles[c])
+            fracture.chunks.push_back(DestructionFragment{ glm::vec3(0.0f), 0.0f, 0.0f });
+    }
+    std::vector<glm::vec3> plainCenter(fracture.chunks.size(), glm::vec3(0.0f));
+    std::vector<float> plainCount(fracture.chunks.size(), 0.0f);
+    for (std::size_t t = 0; t < triangleCount; t++) {
+        std::uint16_t c = chunkOf[t] = renumber[chunkOf[t]];
+        fracture.chunks[c].center += centroid[t] * area[t];
+        fracture.chunks[c].mass += area[t];
+        plainCenter[c] += centroid[t];
+        plainCount[c] += 1.0f;
+    }
+    for (std::size_t c = 0; c < fracture.chunks.size(); c++) {
+        DestructionFragment& chunk = fracture.chunks[c];
+        chunk.center = chunk.mass > 0.0f ? chunk.center / chunk.mass : plainCenter[c] / plainCount[c];
+        chunk.mass = std::max(chunk.mass, 1e-6f);
+    }
+    for (std::size_t t = 0; t < triangleCount; t++) {
+        DestructionFragment& chunk = fracture.chunks[chunkOf[t]];
+        for (int i = 0; i < 3; i++)
+            chunk.radius = std::max(chunk.radius, glm::length(corners[3 * t + i] - chunk.center));
+    }
+
+    fracture.fractureMillis = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return fracture;
+}
+
+bool loadFractureCache(const std::string& path, std::uint64_t sourceHash, std::uint32_t processFlags,
+                       std::size_t triangleCount, Fracture& fracture) {
+    MappedFile file(path);
+    if (!file || file.size() < sizeof(FractureCacheHeader))
+        return false;
+    const FractureCacheHeader* h = (const FractureCacheHeader*)file.data();
+    if (std::memcmp(h->magic, FRACTURE_CACHE_MAGIC, sizeof(h->magic)) != 0 || h->version != FRACTURE_CACHE_VERSION
+        || h->sourceHash != sourceHash || h->processFlags != processFlags || h->triangleCount != triangleCount
+        || h->chunkCount == 0)
+        return false;
+    if (file.size() < sizeof(FractureCacheHeader) + h->chunkCount * sizeof(FractureChunk) + h->triangleCount * sizeof(std::uint16_t))
+        return false;
+
+    const FractureChunk* chunks = (const FractureChunk*)(file.data() + sizeof(FractureCacheHeader));
+    const std::uint16_t* chunkOf = (const std::uint16_t*)(chunks + h->chunkCount);
+    fracture.chunks.clear();
+    for (std::uint32_t c = 0; c < h->chunkCount; c++) {
+        const FractureChunk& chunk = chunks[c];
+        fracture.chunks.push_back(DestructionFragment{ glm::vec3(chunk.center[0], chunk.center[1], chunk.center[2]),
+            chunk.radius, chunk.mass });
+    }
+    fracture.chunkOfTriangle.assign(chunkOf, chunkOf + h->triangleCount);
+    if (std::any_of(fracture.chunkOfTriangle.begin(), fracture.chunkOfTriangle.end(),
+            [h](std::uint16_t c) { return c >= h->chunkCount; }))
+        return false;
+    fracture.fractureMillis = h->fractureMillis;
+    return true;
+}
+
+bool writeFractureCache(const std::string& path, std::uint64_t sourceHash, std::uint32_t processFlags, const Fracture& fracture) {
+    FractureCacheHeader header = {};
+    std::memcpy(header.magic, FRACTURE_CACHE_MAGIC, sizeof(header.magic));
+    header.version = FRACTURE_CACHE_VERSION;
+    header.processFlags = processFlags;
+    header.sourceHash = sourceHash;
+    header.triangleCount = (std::uint32_t)fracture.chunkOfTriangle.size();
+    header.chunkCount = (std::uint32_t)fracture.chunks.size();
+    header.fractureMillis = fracture.fractureMillis;
+
+    std::vector<FractureChunk> chunks;
+    for (const DestructionFragment& f : fracture.chunks)
+        chunks.push_back(FractureChunk{ { f.center.x, f.center.y, f.center.z }, f.radius, f.mass });
+
+    // through a temporary file, like the mesh cache
+    return writeFileReplacing(path, [&](std::ostream& out) {
+        out.write((const char*)&header, sizeof(header));
+        out.write((const char*)chunks.data(), chunks.size() * sizeof(FractureChunk));
+        out.write((const char*)fracture.chunkOfTriangle.data(), fracture.chunkOfTriangle.size() * sizeof(std::uint16_t));
+    });
+}
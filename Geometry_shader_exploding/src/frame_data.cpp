@@ -0,0 +1,17 @@
+#include <learnopengl/frame_data.h>
+#include <learnopengl/gl_state.h>
+
+#include <cstring>
+
+void uploadFrameData(StreamBuffer& stream, const FrameData& data) {
+    static GLint alignment = 0;
+    if (!alignment)
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+    StreamAllocation alloc = stream.allocate(sizeof(FrameData), alignment > 0 ? alignment : 256);
+    if (!alloc.ptr)
+        return;  // keeps the previous frame's range bound
+    std::memcpy(alloc.ptr, &data, sizeof(FrameData));
+    stream.commit(alloc);
+    glState().bindBufferRange(GL_UNIFORM_BUFFER, FRAME_DATA_BINDING, alloc.buffer, alloc.offset, alloc.size);
+}
@@ -0,0 +1,216 @@
+#include <learnopengl/gl_state.h>
+
+#include <algorithm>
+#include <iostream>
+
+// std::fill binds it by reference, so it needs a definition
+const GLuint GLStateCache::UNKNOWN;
+
+// index into GLStateCache::buffers (BufferSlot order)
+static int bufferSlot(GLenum target) {
+    switch (target) {
+    case GL_ARRAY_BUFFER:         return 0;
+    case GL_ELEMENT_ARRAY_BUFFER: return 1;
+    case GL_COPY_WRITE_BUFFER:    return 2;
+    case GL_PIXEL_UNPACK_BUFFER:  return 3;
+    case GL_UNIFORM_BUFFER:       return 4;
+    default:                      return -1;
+    }
+}
+
+// GL 3.3 queries the copy write binding with the target enum itself
+static const GLenum BUFFER_QUERIES[] = {
+    GL_ARRAY_BUFFER_BINDING, GL_ELEMENT_ARRAY_BUFFER_BINDING, GL_COPY_WRITE_BUFFER,
+    GL_PIXEL_UNPACK_BUFFER_BINDING, GL_UNIFORM_BUFFER_BINDING
+};
+
+static int capabilityIndex(GLenum capability) {
+    switch (capability) {
+    case GL_BLEND:              return 0;
+    case GL_DEPTH_TEST:         return 1;
+    case GL_PROGRAM_POINT_SIZE: return 2;
+    case GL_RASTERIZER_DISCARD: return 3;
+    default:                    return -1;
+    }
+}
+
+static const GLenum CAPABILITIES_TRACKED[] = { GL_BLEND, GL_DEPTH_TEST, GL_PROGRAM_POINT_SIZE, GL_RASTERIZER_DISCARD };
+
+GLStateCache& glState() {
+    static GLStateCache cache;
+    return cache;
+}
+
+bool GLStateCache::change(GLuint& cached, GLuint value) {
+    counters.calls++;
+    if (cached == value) {
+        counters.skipped++;
+        return false;
+    }
+    cached = value;
+    return true;
+}
+
+void GLStateCache::useProgram(GLuint id) {
+    if (change(program, id))
+        glUseProgram(id);
+    if (validate) checkAll();
+}
+
+void GLStateCache::bindVertexArray(GLuint id) {
+    if (change(vertexArray, id)) {
+        glBindVertexArray(id);
+        buffers[ELEMENT_ARRAY] = UNKNOWN;  // each vertex array has its own
+    }
+    if (validate) checkAll();
+}
+
+void GLStateCache::bindBuffer(GLenum target, GLuint id) {
+    int slot = bufferSlot(target);
+    if (slot < 0) {
+        counters.calls++;
+        glBindBuffer(target, id);
+        return;
+    }
+    if (change(buffers[slot], id))
+        glBindBuffer(target, id);
+    if (validate) checkAll();
+}
+
+void GLStateCache::bindBufferRange(GLenum target, GLuint index, GLuint id, GLintptr offset, GLsizeiptr length) {
+    counters.calls++;
+    glBindBufferRange(target, index, id, offset, length);
+    int slot = bufferSlot(target);
+    if (slot >= 0)
+        buffers[slot] = id;
+    if (validate) checkAll();
+}
+
+void GLStateCache::activeTexture(GLuint unit) {
+    if (change(activeUnit, unit))
+        glActiveTexture(GL_TEXTURE0 + unit);
+    if (validate) checkAll();
+}
+
+void GLStateCache::bindTexture(GLuint unit, GLuint id) {
+    if (unit >= GL_STATE_TEXTURE_UNITS) {
+        counters.calls++;
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D, id);
+        activeUnit = unit;
+        return;
+    }
+    if (change(textures[unit], id)) {
+        if (activeUnit != unit) {
+            glActiveTexture(GL_TEXTURE0 + unit);
+            activeUnit = unit;
+        }
+        glBindTexture(GL_TEXTURE_2D, id);
+    }
+    if (validate) checkAll();
+}
+
+void GLStateCache::setEnabled(GLenum capability, bool on) {
+    int index = capabilityIndex(capability);
+    counters.calls++;
+    if (index >= 0 && enabled[index] == (on ? 1 : 0)) {
+        counters.skipped++;
+        return;
+    }
+    if (on) glEnable(capability);
+    else    glDisable(capability);
+    if (index >= 0)
+        enabled[index] = on ? 1 : 0;
+    if (validate) checkAll();
+}
+
+void GLStateCache::blendFunc(GLenum source, GLenum destination) {
+    counters.calls++;
+    if (blendSource == source && blendDestination == destination) {
+        counters.skipped++;
+        return;
+    }
+    glBlendFunc(source, destination);
+    blendSource = source;
+    blendDestination = destination;
+    if (validate) checkAll();
+}
+
+void GLStateCache::pointSize(float value) {
+    counters.calls++;
+    if (size == value) {
+        counters.skipped++;
+        return;
+    }
+    glPointSize(value);
+    size = value;
+    if (validate) checkAll();
+}
+
+void GLStateCache::forgetProgram(GLuint id) {
+    if (program == id) program = UNKNOWN;
+}
+
+void GLStateCache::forgetVertexArray(GLuint id) {
+    if (vertexArray == id) {
+        vertexArray = UNKNOWN;
+        buffers[ELEMENT_ARRAY] = UNKNOWN;
+    }
+}
+
+void GLStateCache::forgetBuffer(GLuint id) {
+    for (GLuint& buffer : buffers)
+        if (buffer == id) buffer = UNKNOWN;
+}
+
+void GLStateCache::forgetTexture(GLuint id) {
+    for (GLuint& texture : textures)
+        if (texture == id) texture = UNKNOWN;
+}
+
+void GLStateCache::invalidate() {
+    program = vertexArray = activeUnit = UNKNOWN;
+    std::fill(std::begin(buffers), std::end(buffers), UNKNOWN);
+    std::fill(std::begin(textures), std::end(textures), UNKNOWN);
+    std::fill(std::begin(enabled), std::end(enabled), -1);
+    blendSource = blendDestination = UNKNOWN;
+    size = -1.0f;
+}
+
+void GLStateCache::check(const char* what, GLenum query, GLuint cached) {
+    if (cached == UNKNOWN)
+        return;
+    GLint actual = 0;
+    glGetIntegerv(query, &actual);
+    if ((GLuint)actual != cached) {
+        mismatches++;
+        std::cerr << "GL_STATE::" << what << " cached " << cached << " but GL has " << actual << std::endl;
+    }
+}
+
+void GLStateCache::checkAll() {
+    check("program", GL_CURRENT_PROGRAM, program);
+    check("vertex array", GL_VERTEX_ARRAY_BINDING, vertexArray);
+    for (int slot = 0; slot < BUFFER_SLOTS; slot++)
+        check("buffer", BUFFER_QUERIES[slot], buffers[slot]);
+    check("blend source", GL_BLEND_SRC_RGB, blendSource);
+    check("blend destination", GL_BLEND_DST_RGB, blendDestination);
+    for (int c = 0; c < CAPABILITIES; c++) {
+        if (enabled[c] >= 0 && (glIsEnabled(CAPABILITIES_TRACKED[c]) ? 1 : 0) != enabled[c]) {
+            mismatches++;
+            std::cerr << "GL_STATE::capability 0x" << std::hex << CAPABILITIES_TRACKED[c] << std::dec
+                << " cached " << enabled[c] << " but GL differs" << std::endl;
+        }
+    }
+
+    check("active texture", GL_ACTIVE_TEXTURE, activeUnit == UNKNOWN ? UNKNOWN : GL_TEXTURE0 + activeUnit);
+    GLint unit = 0;
+    glGetIntegerv(GL_ACTIVE_TEXTURE, &unit);
+    for (GLuint u = 0; u < GL_STATE_TEXTURE_UNITS; u++) {
+        if (textures[u] == UNKNOWN)
+            continue;
+        glActiveTexture(GL_TEXTURE0 + u);
+        check("texture", GL_TEXTURE_BINDING_2D, textures[u]);
+    }
+    glActiveTexture((GLenum)unit);
+}
@@ -0,0 +1,84 @@
+#include <learnopengl/gpu_particles.h>
+#include <learnopengl/gl_state.h>
+
+#include <algorithm>
+#include <cstddef>
+
+static const char* FEEDBACK_VARYINGS[] = { "outPos", "outVelocity", "outLife" };
+static const glm::vec3 PARTICLE_GRAVITY_VEC(0.0f, -9.8f, 0.0f);
+
+GpuParticleSystem::GpuParticleSystem(std::size_t capacity, const char* updateShaderPath)
+    : updateShader(updateShaderPath, FEEDBACK_VARYINGS, 3), capacity_(capacity)
+{
+    for (int i = 0; i < 2; i++) {
+        vbo[i] = makeBuffer();
+        vao[i] = makeVertexArray();
+        glState().bindVertexArray(vao[i]);
+        glState().bindBuffer(GL_ARRAY_BUFFER, vbo[i]);
+        glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(GpuParticle), nullptr, GL_DYNAMIC_COPY);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (void*)offsetof(GpuParticle, pos));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (void*)offsetof(GpuParticle, velocity));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (void*)offsetof(GpuParticle, life));
+    }
+    glState().bindVertexArray(0);
+
+    updateShader.use();
+    updateShader.setVec3("gravity", PARTICLE_GRAVITY_VEC);
+    deltaTimeUniform = updateShader.uniform("deltaTime");
+}
+
+GpuParticleSystem::~GpuParticleSystem() {
+    glState().forgetProgram(updateShader.ID);
+    glDeleteProgram(updateShader.ID);
+}
+
+void GpuParticleSystem::emit(const GpuParticle* particles, std::size_t n) {
+    n = std::min(n, capacity_);
+    glState().bindBuffer(GL_ARRAY_BUFFER, vbo[cur]);
+    std::size_t first = std::min(n, capacity_ - cursor);
+    glBufferSubData(GL_ARRAY_BUFFER, cursor * sizeof(GpuParticle), first * sizeof(GpuParticle), particles);
+    if (first < n)
+        glBufferSubData(GL_ARRAY_BUFFER, 0, (n - first) * sizeof(GpuParticle), particles + first);
+    cursor = (cursor + n) % capacity_;
+    used = std::min(capacity_, used + n);
+
+    for (std::size_t i = 0; i < n; i++)
+        lifeLeft = std::max(lifeLeft, particles[i].life);
+}
+
+void GpuParticleSystem::update(float dt) {
+    if (idle())
+        return;
+    lifeLeft -= dt;
+
+    updateShader.use();
+    updateShader.setFloat(deltaTimeUniform, dt);
+
+    glState().setEnabled(GL_RASTERIZER_DISCARD, true);
+    glState().bindVertexArray(vao[cur]);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, vbo[1 - cur]);
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, 0, (GLsizei)used);
+    glEndTransformFeedback();
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glState().setEnabled(GL_RASTERIZER_DISCARD, false);
+
+    cur = 1 - cur;
+}
+
+void GpuParticleSystem::draw() const {
+    if (idle())
+        return;
+    glState().bindVertexArray(vao[cur]);
+    glDrawArrays(GL_POINTS, 0, (GLsizei)used);
+}
+
+void GpuParticleSystem::clear() {
+    // slots past `used` are never read, and emits refill the ring from slot 0
+    cursor = 0;
+    used = 0;
+    lifeLeft = 0.0f;
+}
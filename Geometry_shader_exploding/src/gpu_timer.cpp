@@ -0,0 +1,47 @@
+#include <learnopengl/gpu_timer.h>
+
+GpuTimer::GpuTimer() {
+    for (GLQuery& query : queries)
+        query = makeQuery();
+}
+
+void GpuTimer::collect() {
+    for (int i = 0; i < GPU_TIMER_QUERIES; i++) {
+        if (!pending[i])
+            continue;
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv(queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            continue;
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(queries[i], GL_QUERY_RESULT, &nanoseconds);
+        pending[i] = false;
+        totalMillis += nanoseconds / 1.0e6;
+        samples_++;
+    }
+}
+
+void GpuTimer::begin() {
+    collect();
+    running = !pending[next];
+    if (running)
+        glBeginQuery(GL_TIME_ELAPSED, queries[next]);
+}
+
+void GpuTimer::end() {
+    if (!running)
+        return;
+    glEndQuery(GL_TIME_ELAPSED);
+    pending[next] = true;
+    next = (next + 1) % GPU_TIMER_QUERIES;
+    running = false;
+}
+
+void GpuTimer::reset() {
+    collect();
+    // results still in flight belong to the old measurement
+    for (bool& p : pending)
+        p = false;
+    totalMillis = 0.0;
+    samples_ = 0;
+}
@@ -0,0 +1,66 @@
+#include <learnopengl/instancing.h>
+#include <learnopengl/gl_state.h>
+
+#include <cstring>
+
+void setInstanceDefaults() {
+    for (GLuint column = 0; column < 4; column++) {
+        glm::vec4 identity(0.0f);
+        identity[column] = 1.0f;
+        glVertexAttrib4f(INSTANCE_MODEL_LOCATION + column, identity.x, identity.y, identity.z, identity.w);
+    }
+    glVertexAttrib4f(INSTANCE_TINT_LOCATION, 1.0f, 1.0f, 1.0f, 1.0f);
+    glVertexAttrib4f(INSTANCE_PARAMS_LOCATION, -1.0f, 0.0f, 0.0f, 0.0f);
+}
+
+void enableInstanceAttributes(GLuint buffer, GLintptr offset) {
+    glState().bindBuffer(GL_ARRAY_BUFFER, buffer);
+    for (GLuint i = 0; i < 6; i++) {
+        GLuint location = INSTANCE_MODEL_LOCATION + i;
+        glEnableVertexAttribArray(location);
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+            (void*)(offset + i * sizeof(glm::vec4)));
+        glVertexAttribDivisor(location, 1);
+    }
+}
+
+void disableInstanceAttributes() {
+    for (GLuint i = 0; i < 6; i++)
+        glDisableVertexAttribArray(INSTANCE_MODEL_LOCATION + i);
+}
+
+void InstanceGroups::clear() {
+    for (std::vector<InstanceData>& group : groups)
+        group.clear();
+    uploadedBuffer = 0;
+}
+
+std::size_t InstanceGroups::total() const {
+    std::size_t count = 0;
+    for (const std::vector<InstanceData>& group : groups)
+        count += group.size();
+    return count;
+}
+
+bool InstanceGroups::upload(StreamBuffer& stream) {
+    std::size_t count = total();
+    if (count == 0)
+        return true;
+    StreamAllocation alloc = stream.allocate((GLsizeiptr)(count * sizeof(InstanceData)), sizeof(glm::vec4));
+    if (!alloc.ptr)
+        return false;
+
+    char* out = (char*)alloc.ptr;
+    GLintptr offset = alloc.offset;
+    for (std::size_t g = 0; g < groups.size(); g++) {
+        std::size_t bytes = groups[g].size() * sizeof(InstanceData);
+        if (bytes)
+            std::memcpy(out, groups[g].data(), bytes);
+        offsets[g] = offset;
+        out += bytes;
+        offset += (GLintptr)bytes;
+    }
+    stream.commit(alloc);
+    uploadedBuffer = alloc.buffer;
+    return true;
+}
@@ -1,6 +1,19 @@
 #include <learnopengl/shader.h>     
 #include <learnopengl/camera.h>     
 #include <learnopengl/model.h>      
+#include <learnopengl/asset_manager.h>
+#include <learnopengl/asset_loader.h>
+#include <learnopengl/culling.h>
+#include <learnopengl/particles.h>
+#include <learnopengl/particle_sort.h>
+#include <learnopengl/gpu_particles.h>
+#include <learnopengl/debris.h>
+#include <learnopengl/stream_buffer.h>
+#include <learnopengl/frame_data.h>
+#include <learnopengl/gl_state.h>
+#include <learnopengl/render_queue.h>
+#include <learnopengl/instancing.h>
+#include <learnopengl/gpu_timer.h>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
@@ -15,6 +28,7 @@
 #include <sstream>
 #include <iostream>
 #include <array>
+#include <memory>
 #include <random>
 #include <vector>
 
@@ -49,8 +63,62 @@ float      lastDashTime = -dashCooldown;
 // explosion state for Car A's 4 cars
 std::array<bool, 4>  exploded = { false,false,false,false };
 std::array<float, 4> explosionStart = { -1,-1,-1,-1 };
+std::array<float, 4> debrisState = { -1,-1,-1,-1 };  // as parkedCars' params.y
 const float explosionDuration = 2.0f;
 
+// level of detail: screen-space error allowed before a finer level is drawn
+const float LOD_MAX_ERROR_PIXELS = 1.0f;
+const float CAMERA_FOV_Y = glm::radians(45.0f);
+const float CAMERA_NEAR = 0.1f, CAMERA_FAR = 100.0f;
+std::array<LodSelector, 4> carALod;
+LodSelector carBLod;
+
+// parked copies of Car A in a grid behind the play area, P key toggles
+const int PARKED_CAR_COLUMNS = 100, PARKED_CAR_ROWS = 100;
+const float PARKED_CAR_SPACING_X = 2.5f, PARKED_CAR_SPACING_Z = 5.0f;
+bool showParkedCars = false;
+float lastParkedToggle = -1.0f;
+std::vector<InstanceData> parkedCars;  // params.x is the explosion start, as for the scene cars; params.y is negative until the car's explosion
+// is first seen, then 1 if its wreck went to the debris field and 0 if not
+std::vector<LodSelector> parkedCarLod;
+std::vector<char> parkedCarSpread;  // the car has lit its neighbours already
+// an exploding parked car ignites its four grid neighbours after this delay
+const float CHAIN_REACTION_DELAY = 0.12f;
+const ParticleEmitter chainEmitter = { 200, 0 };
+// every Car A instance is drawn instanced: one group per LOD level intact, one for the exploding ones,
+// and the cars detonating this frame on the debris path, which are captured instead of drawn
+const unsigned int EXPLODING_GROUP = MAX_MESH_LODS + 1;
+const unsigned int DETONATION_GROUP = MAX_MESH_LODS + 2;
+InstanceGroups carAInstances(MAX_MESH_LODS + 3);
+
+// exploding cars (V key cycles): geometry shader over the indexed mesh, vertex shader over the explodable
+// copy, playback of the baked destruction, whose wrecks stay where they settled, or transform feedback
+// capture into the debris field, whose triangles keep falling and lie around for good
+enum class ExplosionPath { GeometryShader, VertexShader, Baked, Debris, Count };
+ExplosionPath explosionPath = ExplosionPath::GeometryShader;
+float lastPathToggle = -1.0f;
+// GPU time of the exploding group per path, and the cars it held
+struct ExplosionBenchmark {
+    GpuTimer timer;
+    std::size_t frames = 0, instances = 0;
+};
+const char* explosionPathName(ExplosionPath path) {
+    static const char* const names[] = { "geometry shader", "vertex shader", "baked destruction", "transform feedback debris" };
+    return names[(int)path];
+}
+
+// frustum culling of every drawable, rebuilt each frame
+CullingBatch cullingBatch;
+// draw packets of the frame, sorted by state and depth before they run
+RenderQueue renderQueue;
+const unsigned int SCENE_PASS = 0;
+const std::size_t NOT_SUBMITTED = ~(std::size_t)0;
+const BoundingSphere FLOOR_BOUNDS = { glm::vec3(0.0f), 10.0f * 1.4142136f };
+// the explosion geometry shader pushes triangles 6 units per second along their normals
+const float EXPLOSION_REACH = 6.0f * 2.0f;
+// wrecks the debris ring holds, sized from the first car captured; the oldest are recycled once it is full
+const std::size_t DEBRIS_RING_WRECKS = 16;
+
 // Car B (rideable) state
 glm::vec3 carBPos = INITIAL_CAR_B_POS;
 bool       inCar = false;
@@ -65,16 +133,26 @@ float lastX = SCR_WIDTH / 2.0f, lastY = SCR_HEIGHT / 2.0f;
 bool  firstMouse = true;
 float distanceToCube = 5.0f;
 
+// per-frame transient vertex / uniform data
+const GLsizeiptr STREAM_FRAME_SIZE = 4 * 1024 * 1024;
+std::unique_ptr<StreamBuffer> streamBuffer;
+
+// GL thread time per frame spent uploading assets the loader threads finished
+const float ASSET_UPLOAD_BUDGET_MS = 4.0f;
+
 // particle system
-struct Particle {
-    glm::vec3 pos;
-    glm::vec3 velocity;
-    float     life;
-    bool      active;
-};
-const int MAX_PARTICLES = 5000;
-std::vector<Particle> particles;
-GLuint particleVAO, particleVBO;
+enum class ParticleBackend { Cpu, Gpu };  // G key toggles
+ParticleBackend particleBackend = ParticleBackend::Cpu;
+float lastBackendToggle = -1.0f;
+const ParticleEmitter explosionEmitter = { 5000, 1 };
+const int MAX_PARTICLES = 4 * 5000;  // room for every Car A exploding at once
+ParticlePool particles(MAX_PARTICLES);
+ParticleKernel particleKernel = ParticleKernel::Simd;
+GLuint particleVAO;
+std::unique_ptr<GpuParticleSystem> gpuParticles;
+std::vector<GpuParticle> gpuEmitStaging;
+ParticleDepthSorter particleSorter;  // CPU backend, back to front for blending
+float lastSortBenchmark = -1.0f;
 std::default_random_engine generator;
 std::uniform_real_distribution<float> distrib(-1.0f, 1.0f);
 
@@ -82,15 +160,17 @@ std::uniform_real_distribution<float> distrib(-1.0f, 1.0f);
 void framebuffer_size_callback(GLFWwindow* w, int width, int height);
 void mouse_callback(GLFWwindow* w, double xpos, double ypos);
 void processInput(GLFWwindow* w);
-unsigned int loadTexture(const char* path);
 void initParticles();
-void emitParticles(glm::vec3 center);
-void updateParticles(float dt);
+void emitParticles(glm::vec3 center, const ParticleEmitter& emitter);
+void initParkedCars();
+void updateParkedCars(const glm::vec3& ref, float currentTime);
 
 int main()
 {
     // GLFW init
     glfwInit();
+    // terminates GLFW only after every GL-owning local of main (models, meshes) has been destroyed
+    struct GlfwGuard { ~GlfwGuard() { glfwTerminate(); } } glfwGuard;
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
@@ -106,11 +186,19 @@ int main()
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
         std::cerr << "Failed to initialize GLAD\n"; return -1;
     }
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glEnable(GL_PROGRAM_POINT_SIZE);
-    stbi_set_flip_vertically_on_load(true);
+    // every bind / program / capability change goes through the state cache
+    GLStateCache& state = glState();
+    state.setEnabled(GL_DEPTH_TEST, true);
+    state.setEnabled(GL_BLEND, true);
+    state.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    state.setEnabled(GL_PROGRAM_POINT_SIZE, true);
+    // instance attributes of non-instanced draws: identity transform, white tint
+    setInstanceDefaults();
+
+    // streaming buffer, persistently mapped when ARB_buffer_storage is available
+    bool persistentStreaming = loadBufferStorage((GLADloadproc)glfwGetProcAddress);
+    streamBuffer = std::make_unique<StreamBuffer>(STREAM_FRAME_SIZE);
+    std::cout << "Stream buffer: " << (persistentStreaming ? "persistent mapping" : "unsynchronized mapping") << std::endl;
 
     // load shaders
     Shader basicShader("shader/basic.vs", "shader/basic.fs");
@@ -119,13 +207,50 @@ int main()
         "shader/9.2.geometry_shader.fs",
         "shader/9.2.geometry_shader.gs"
     );
+    Shader explodeVsShader("shader/explode.vs", "shader/9.2.geometry_shader.fs");
+    Shader destructionShader("shader/destruction.vs", "shader/9.2.geometry_shader.fs");
+    Shader debrisShader("shader/debris.vs", "shader/9.2.geometry_shader.fs");
     Shader floorShader("shader/basic.vs", "shader/basic.fs");
     Shader particleShader("shader/particle.vs", "shader/particle.fs");
-
-    // load models
-    Model cubeModel("resources/objects/cube/cube.obj");
-    Model carModelA("resources/objects/sportscar/sportsCar.obj");
-    Model carModelB("resources/objects/sportscar/sportsCar.obj");
+    Shader particleGpuShader("shader/particle_gpu.vs", "shader/particle.fs");
+    // per-instance uniforms, resolved once
+    const UniformHandle basicModel = basicShader.uniform("model");
+    const UniformHandle explodeModel = explodeShader.uniform("model");
+    const UniformHandle explodeVsModel = explodeVsShader.uniform("model");
+    const UniformHandle destructionModel = destructionShader.uniform("model");
+    const UniformHandle destructionFps = destructionShader.uniform("destructionFps");
+    destructionShader.use();
+    destructionShader.setInt("destructionFrames", DESTRUCTION_TEXTURE_UNIT);
+
+    // wrecks of the debris path, resting on the floor plane
+    DebrisField debris(DEBRIS_RING_WRECKS, 0.0f, "shader/debris_capture.vs", "shader/debris_update.vs");
+    const UniformHandle debrisCaptureModel = debris.captureShader().uniform("model");
+
+    // load models in the background, uploading only the (quantized) attributes the model shaders read
+    ModelLoadOptions modelOptions;
+    modelOptions.format = VertexFormat::consumedBy({ &basicShader, &explodeShader }, true);
+    modelOptions.optimize = true;
+    modelOptions.generateLods = true;
+    modelOptions.explodable = true;
+    modelOptions.keepCpuData = false;
+    // Car A and Car B share one GPU copy of the sports car through the asset registry
+    AssetManager assets;
+    AssetLoader loader(assets);
+    auto cubeModel = loader.requestModel("resources/objects/cube/cube.obj", modelOptions);
+    auto carModelA = loader.requestModel("resources/objects/sportscar/sportsCar.obj", modelOptions);
+    auto carModelB = loader.requestModel("resources/objects/sportscar/sportsCar.obj", modelOptions);
+    auto floorTexture = loader.requestTexture("metal.png", "resources/objects/textures");
+    unsigned int assetsShown = 0;
+    bool titleStale = false;
+    CullingStats titleStats;
+    std::size_t titleSaved = 0;
+    glfwSetWindowTitle(window, "Project - loading 0%");
+
+    // drawn in place of every model that is still loading
+    Model placeholder = Model::placeholder(modelOptions);
+    auto drawable = [&placeholder](const std::shared_ptr<const AssetLoader::ModelRequest>& request) -> Model& {
+        return request->ready() ? *request->asset : placeholder;
+    };
 
     // floor setup
     float floorVerts[] = {
@@ -139,26 +264,72 @@ int main()
     GLuint floorVAO, floorVBO;
     glGenVertexArrays(1, &floorVAO);
     glGenBuffers(1, &floorVBO);
-    glBindVertexArray(floorVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, floorVBO);
+    state.bindVertexArray(floorVAO);
+    state.bindBuffer(GL_ARRAY_BUFFER, floorVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(floorVerts), floorVerts, GL_STATIC_DRAW);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    // textures
-    unsigned int floorTex = loadTexture("resources/objects/textures/metal.png");
-    floorShader.use(); floorShader.setInt("texture1", 0);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+
+    // texture_diffuse1 is on unit 0 already (see samplerUnit)
+    floorShader.use();
+    floorShader.setVec3("positionOffset", glm::vec3(0.0f));
+    floorShader.setVec3("positionScale", glm::vec3(1.0f));
+    floorShader.setMat4("model", glm::mat4(1.0f));
+    // constant point size of both particle backends
+    particleShader.use();
+    particleShader.setFloat("pointSize", 40.0f);
+    particleGpuShader.use();
+    particleGpuShader.setFloat("pointSize", 40.0f);
 
     // init particle system
     initParticles();
+    initParkedCars();
+
+    // Car A instances submitted for culling each frame
+    struct CarInstance {
+        std::size_t cull;
+        InstanceData instance;
+        LodSelector* lod;
+    };
+    std::vector<CarInstance> carACandidates;
+    ExplosionBenchmark explosionBenchmarks[(int)ExplosionPath::Count];
+    auto reportExplosions = [&explosionBenchmarks](ExplosionPath path) {
+        ExplosionBenchmark& b = explosionBenchmarks[(int)path];
+        if (b.frames == 0)
+            return;
+        std::cout << "Explosions (" << explosionPathName(path) << "): " << b.timer.averageMillis() << " ms GPU per frame over "
+            << b.timer.samples() << " frames, " << (double)b.instances / b.frames << " cars on average";
+        // the same motion on both, only where the face normal comes from differs
+        if (path == ExplosionPath::GeometryShader || path == ExplosionPath::VertexShader)
+            std::cout << ", faces pushed along " << (path == ExplosionPath::GeometryShader ? "clip" : "world") << "-space normals";
+        std::cout << std::endl;
+    };
 
     // render loop
+    bool firstFrame = true;
+    std::size_t frameCount = 0;
+    std::size_t queuedChanges = 0, unsortedChanges = 0;
+    std::size_t startupLocationQueries = 0;
     while (!glfwWindowShouldClose(window)) {
         float currentTime = glfwGetTime();
         deltaTime = currentTime - lastFrame;
         lastFrame = currentTime;
+        streamBuffer->beginFrame();
+
+        // swap in whatever the loader threads finished
+        loader.update(ASSET_UPLOAD_BUDGET_MS);
+        if (loader.completed() != assetsShown) {
+            assetsShown = loader.completed();
+            std::string title = "Project - loading " + std::to_string((int)(loader.progress() * 100.0f)) + "%";
+            if (!loader.idle())
+                glfwSetWindowTitle(window, title.c_str());
+            titleStale = loader.idle();
+            if (loader.idle())
+                std::cout << "Assets: " << assets.stats().modelLoads << "/" << assets.stats().modelRequests << " models and "
+                    << assets.stats().textureLoads << "/" << assets.stats().textureRequests << " textures loaded" << std::endl;
+        }
 
         if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS) {
             float now = glfwGetTime();
@@ -175,6 +346,7 @@ int main()
             for (int i = 0; i < 4; ++i) {
                 exploded[i] = false;
                 explosionStart[i] = -1.0f;
+                debrisState[i] = -1.0f;
             }
 
             // 4) Car B  ʱȭ
@@ -190,10 +362,15 @@ int main()
             lastY = SCR_HEIGHT / 2.0f;
             firstMouse = true;
 
-            // 6) ƼŬ  Ȱȭ
-            for (auto& p : particles) {
-                p.active = false;
-            }
+            // 6) ƼŬ  Ȱȭ
+            particles.clear();
+            gpuParticles->clear();
+            debris.clear();
+
+            // 7)   
+            for (InstanceData& car : parkedCars)
+                car.params.x = car.params.y = -1.0f;
+            std::fill(parkedCarSpread.begin(), parkedCarSpread.end(), 0);
         }
 
         processInput(window);
@@ -231,6 +408,37 @@ int main()
             lastExitTime = currentTime;
         }
 
+        // switch particle simulation between CPU and GPU (transform feedback)
+        if (glfwGetKey(window, GLFW_KEY_G) == GLFW_PRESS && currentTime - lastBackendToggle > 0.5f) {
+            particleBackend = particleBackend == ParticleBackend::Cpu ? ParticleBackend::Gpu : ParticleBackend::Cpu;
+            particles.clear();
+            gpuParticles->clear();
+            std::cout << "Particle backend: " << (particleBackend == ParticleBackend::Cpu ? "CPU" : "GPU") << std::endl;
+            lastBackendToggle = currentTime;
+        }
+
+        // switch how exploding cars are drawn, reporting the path left behind
+        if (glfwGetKey(window, GLFW_KEY_V) == GLFW_PRESS && currentTime - lastPathToggle > 0.5f) {
+            reportExplosions(explosionPath);
+            explosionPath = (ExplosionPath)(((int)explosionPath + 1) % (int)ExplosionPath::Count);
+            std::cout << "Explosion path: " << explosionPathName(explosionPath) << std::endl;
+            lastPathToggle = currentTime;
+        }
+
+        // time the particle depth sort at several particle counts
+        if (glfwGetKey(window, GLFW_KEY_B) == GLFW_PRESS && currentTime - lastSortBenchmark > 0.5f) {
+            benchmarkParticleSort();
+            lastSortBenchmark = currentTime;
+        }
+
+        // show / hide the parked cars
+        if (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS && currentTime - lastParkedToggle > 0.5f) {
+            showParkedCars = !showParkedCars;
+            titleStale = true;
+            std::cout << "Parked cars: " << (showParkedCars ? std::to_string(parkedCars.size()) : std::string("off")) << std::endl;
+            lastParkedToggle = currentTime;
+        }
+
         // Car A explosion triggers & emit particles
         for (int i = 0; i < 4; i++) {
             if (!exploded[i]) {
@@ -238,13 +446,19 @@ int main()
                 if (glm::length(ref - INITIAL_CAR_A_POS[i]) < 1.5f) {
                     exploded[i] = true;
                     explosionStart[i] = currentTime;
-                    emitParticles(INITIAL_CAR_A_POS[i]);
+                    emitParticles(INITIAL_CAR_A_POS[i], explosionEmitter);
                 }
             }
         }
 
+        if (showParkedCars)
+            updateParkedCars(inCar ? carBPos : cubePos, currentTime);
+
         // update particle physics
-        updateParticles(deltaTime);
+        if (particleBackend == ParticleBackend::Cpu)
+            updateParticles(particles, deltaTime, particleKernel);
+        else
+            gpuParticles->update(deltaTime);
 
         // Car B controls
         if (inCar) {
@@ -275,150 +489,399 @@ int main()
         glm::vec3 camPos = target + offset;
         glm::mat4 view = glm::lookAt(camPos, target, glm::vec3(0, 1, 0));
         glm::mat4 projection = glm::perspective(
-            glm::radians(45.0f), (float)SCR_WIDTH / SCR_HEIGHT, 0.1f, 100.0f
+            CAMERA_FOV_Y, (float)SCR_WIDTH / SCR_HEIGHT, CAMERA_NEAR, CAMERA_FAR
         );
+        // camera matrices for every program, one upload per frame
+        FrameData frameData;
+        frameData.view = view;
+        frameData.projection = projection;
+        frameData.viewProjection = projection * view;
+        frameData.cameraPosition = glm::vec4(camPos, 1.0f);
+        frameData.time = currentTime;
+        frameData.deltaTime = deltaTime;
+        uploadFrameData(*streamBuffer, frameData);
+
+        // LOD of a model instance placed by transform, uniformly scaled by scale
+        auto selectLod = [&](LodSelector& selector, const Model& model, const glm::mat4& transform, float scale) {
+            glm::vec3 center = glm::vec3(transform * glm::vec4(model.boundingCenter(), 1.0f));
+            float radius = projectedRadius(center, model.boundingRadius() * scale, camPos, CAMERA_FOV_Y, (float)SCR_HEIGHT);
+            return selector.select(model, radius, LOD_MAX_ERROR_PIXELS);
+        };
 
-        // clear
-        glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-        // draw floor
-        floorShader.use();
-        floorShader.setMat4("view", view);
-        floorShader.setMat4("projection", projection);
-        floorShader.setMat4("model", glm::mat4(1.0f));
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, floorTex);
-        glBindVertexArray(floorVAO);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-
-        // draw cube
-        if (!inCar) {
-            basicShader.use();
-            basicShader.setMat4("view", view);
-            basicShader.setMat4("projection", projection);
-            glm::mat4 mc = glm::translate(glm::mat4(1.0f), cubePos);
-            mc = glm::rotate(mc, glm::radians(-yaw + 90.0f), glm::vec3(0, 1, 0));
-            mc = glm::scale(mc, glm::vec3(0.5f));
-            basicShader.setMat4("model", mc);
-            cubeModel.Draw(basicShader);
+        // instance transforms
+        glm::mat4 mc = glm::translate(glm::mat4(1.0f), cubePos);
+        mc = glm::rotate(mc, glm::radians(-yaw + 90.0f), glm::vec3(0, 1, 0));
+        mc = glm::scale(mc, glm::vec3(0.5f));
+        std::array<glm::mat4, 4> ma;
+        for (int i = 0; i < 4; i++) {
+            ma[i] = glm::translate(glm::mat4(1.0f), INITIAL_CAR_A_POS[i]);
+            if (!exploded[i])
+                ma[i] = glm::scale(ma[i], glm::vec3(0.7f));
         }
+        glm::mat4 mb = glm::translate(glm::mat4(1.0f), carBPos);
+        mb = glm::rotate(mb, glm::radians(-carBYaw + 90.0f), glm::vec3(0, 1, 0));
+        mb = glm::scale(mb, glm::vec3(0.7f));
+
+        // frustum culling: the bounds of everything about to be drawn are tested in one batch
+        cullingBatch.clear();
+        std::size_t floorCull = cullingBatch.add(FLOOR_BOUNDS);
+        std::size_t cubeCull = inCar ? NOT_SUBMITTED
+            : cullingBatch.add(transformSphere(drawable(cubeModel).boundingSphere(), mc));
+        // paths the loaded model cannot take fall back to the geometry shader
+        Model& carA = drawable(carModelA);
+        ExplosionPath path = explosionPath;
+        if (((path == ExplosionPath::VertexShader || path == ExplosionPath::Debris) && !carA.explodable())
+            || (path == ExplosionPath::Baked && !carA.hasDestruction()))
+            path = ExplosionPath::GeometryShader;
+        // baked wrecks stay for good and are bounded by the bake; the debris path hands a car over to the
+        // debris field the moment it detonates, if the ring takes its wreck; the rest fly apart and vanish
+        const bool wrecksStay = path == ExplosionPath::Baked;
+        const bool captureDebris = path == ExplosionPath::Debris;
+        const BoundingSphere carASphere = carA.boundingSphere();
+        auto carBounds = [&](const glm::mat4& transform, float start) {
+            if (start >= 0.0f && wrecksStay)
+                return transformSphere(BoundingSphere{ carASphere.center, carA.destructionReach() }, transform);
+            BoundingSphere bounds = transformSphere(carASphere, transform);
+            if (start >= 0.0f)
+                bounds.radius += EXPLOSION_REACH;
+            return bounds;
+        };
+        auto gone = [&](float start, float state) {
+            return start >= 0.0f && (state > 0.0f || (!wrecksStay && currentTime - start >= explosionDuration));
+        };
+        // The first frame a car is seen exploding, however late its start, decides whether it goes to the
+        // debris field, visible or not; true then if it got a wreck. Cars the ring turns down, or that went
+        // off on another path, keep exploding the ordinary way.
+        const std::size_t wreckVertices = carA.explodedVertexCount();
+        auto captured = [&](float start, float& state) {
+            if (start < 0.0f || start > currentTime || state >= 0.0f)
+                return false;
+            state = captureDebris && debris.reserveWreck(wreckVertices) ? 1.0f : 0.0f;
+            return state > 0.0f;
+        };
 
-        // draw Car A & explosions
+        carACandidates.clear();
+        carAInstances.clear();
         for (int i = 0; i < 4; i++) {
-            if (!exploded[i]) {
-                basicShader.use();
-                basicShader.setMat4("view", view);
-                basicShader.setMat4("projection", projection);
-                glm::mat4 ma = glm::translate(glm::mat4(1.0f), INITIAL_CAR_A_POS[i]);
-                ma = glm::scale(ma, glm::vec3(0.7f));
-                basicShader.setMat4("model", ma);
-                carModelA.Draw(basicShader);
+            InstanceData instance;
+            instance.model = ma[i];
+            instance.params.x = exploded[i] ? explosionStart[i] : -1.0f;
+            if (captured(instance.params.x, debrisState[i]))
+                carAInstances.add(DETONATION_GROUP, instance);
+            if (!gone(instance.params.x, debrisState[i]))
+                carACandidates.push_back(CarInstance{ cullingBatch.add(carBounds(ma[i], instance.params.x)), instance, &carALod[i] });
+        }
+        if (showParkedCars) {
+            for (std::size_t i = 0; i < parkedCars.size(); i++) {
+                InstanceData car = parkedCars[i];
+                float start = car.params.x;
+                if (start >= 0.0f)  // explodes unscaled, like the scene cars
+                    car.model = glm::translate(glm::mat4(1.0f), glm::vec3(car.model[3]));
+                if (captured(start, parkedCars[i].params.y))
+                    carAInstances.add(DETONATION_GROUP, car);
+                if (!gone(start, parkedCars[i].params.y))
+                    carACandidates.push_back(CarInstance{ cullingBatch.add(carBounds(car.model, start)), car, &parkedCarLod[i] });
+            }
+        }
+        std::size_t carBCull = cullingBatch.add(transformSphere(drawable(carModelB).boundingSphere(), mb));
+        cullingBatch.cull(extractFrustum(frameData.viewProjection));
+        auto visible = [](std::size_t cull) { return cull != NOT_SUBMITTED && cullingBatch.visible(cull); };
+
+        // sort key of an opaque instance drawn with shader from vertexArray; without a transform the
+        // packet spans the scene (instance groups, debris) and has no single depth
+        struct OpaqueKey {
+            const glm::vec3& camPos;
+            SortKeyFields operator()(const Shader& shader, GLuint vertexArray, unsigned int material) const {
+                SortKeyFields key;
+                key.pass = SCENE_PASS;
+                key.program = shader.ID;
+                key.vertexArray = vertexArray;
+                key.material = material;
+                return key;
+            }
+            SortKeyFields operator()(const Shader& shader, GLuint vertexArray, unsigned int material,
+                                     const glm::mat4& transform) const {
+                SortKeyFields key = (*this)(shader, vertexArray, material);
+                key.depth = glm::length(glm::vec3(transform[3]) - camPos) / CAMERA_FAR;
+                return key;
             }
-            else {
-                float t = currentTime - explosionStart[i];
-                if (t < explosionDuration) {
-                    explodeShader.use();
-                    explodeShader.setMat4("view", view);
-                    explodeShader.setMat4("projection", projection);
-                    explodeShader.setMat4("model",
-                        glm::translate(glm::mat4(1.0f), INITIAL_CAR_A_POS[i])
-                    );
-                    explodeShader.setFloat("explosionTime", t);
-                    carModelA.Draw(explodeShader);
+        } opaqueKey{ camPos };
+
+        // floor
+        if (visible(floorCull)) {
+            GLuint texture = floorTexture->ready() ? floorTexture->asset->get() : 0;
+            renderQueue.submit(opaqueKey(floorShader, floorVAO, texture), [&floorShader, &state, floorVAO, texture]() {
+                floorShader.use();
+                state.bindTexture(0, texture);
+                state.bindVertexArray(floorVAO);
+                glDrawArrays(GL_TRIANGLES, 0, 6);
+            });
+        }
+
+        // cube
+        if (visible(cubeCull)) {
+            Model& cube = drawable(cubeModel);
+            renderQueue.submit(opaqueKey(basicShader, cube.vertexArray(), cube.materialKey(), mc), [&basicShader, &cube, basicModel, mc]() {
+                basicShader.use();
+                basicShader.setMat4(basicModel, mc);
+                cube.Draw(basicShader);
+            });
+        }
+
+        // Car A & explosions: visible instances grouped by LOD level, one instanced draw per group.
+        // Every car exploding at once, however many a chain reaction set off, is a single draw.
+        for (const CarInstance& car : carACandidates) {
+            if (!visible(car.cull))
+                continue;
+            if (car.instance.params.x >= 0.0f)
+                carAInstances.add(EXPLODING_GROUP, car.instance);
+            else
+                carAInstances.add(selectLod(*car.lod, carA, car.instance.model, 0.7f), car.instance);
+        }
+        // the debris packet below captures the cars that detonated, one wreck each
+        GLuint detonationBuffer = 0;
+        GLintptr detonationOffset = 0;
+        GLsizei detonations = 0;
+        if (carAInstances.upload(*streamBuffer)) {
+            for (unsigned int group = 0; group < carAInstances.groupCount(); group++) {
+                GLsizei count = carAInstances.count(group);
+                if (count == 0)
+                    continue;
+                GLuint buffer = carAInstances.buffer();
+                GLintptr offset = carAInstances.offset(group);
+                if (group == DETONATION_GROUP) {
+                    detonationBuffer = buffer;
+                    detonationOffset = offset;
+                    detonations = count;
+                    continue;
+                }
+                if (group != EXPLODING_GROUP) {
+                    SortKeyFields key = opaqueKey(basicShader, carA.vertexArray(), carA.materialKey());
+                    renderQueue.submit(key, [&basicShader, &carA, basicModel, buffer, offset, count, group]() {
+                        basicShader.use();
+                        basicShader.setMat4(basicModel, glm::mat4(1.0f));
+                        carA.DrawInstanced(basicShader, buffer, offset, count, group);
+                    });
+                    continue;
                 }
+
+                // the vertex shader and baked paths both draw the explodable copy
+                bool vertexPath = path != ExplosionPath::GeometryShader;
+                Shader& shader = path == ExplosionPath::Baked ? destructionShader : vertexPath ? explodeVsShader : explodeShader;
+                UniformHandle model = path == ExplosionPath::Baked ? destructionModel : vertexPath ? explodeVsModel : explodeModel;
+                // cars the debris ring turned down are timed with the vertex shader path they took
+                ExplosionBenchmark& benchmark = explosionBenchmarks[(int)(path == ExplosionPath::Debris ? ExplosionPath::VertexShader : path)];
+                benchmark.frames++;
+                benchmark.instances += count;
+                SortKeyFields key = opaqueKey(shader, vertexPath ? carA.explodeVertexArray() : carA.vertexArray(),
+                    carA.materialKey());
+                bool baked = path == ExplosionPath::Baked;
+                renderQueue.submit(key, [&shader, &carA, &benchmark, model, destructionFps, buffer, offset, count, vertexPath, baked]() {
+                    shader.use();
+                    shader.setMat4(model, glm::mat4(1.0f));
+                    if (baked)
+                        carA.bindDestruction(shader, destructionFps);
+                    benchmark.timer.begin();
+                    if (vertexPath)
+                        carA.DrawExplodedInstanced(buffer, offset, count);
+                    else
+                        carA.DrawInstanced(shader, buffer, offset, count);
+                    benchmark.timer.end();
+                });
             }
         }
 
-        // draw particles
-        {
-            // collect active positions
-            std::vector<glm::vec3> activePos;
-            activePos.reserve(MAX_PARTICLES);
-            for (auto& p : particles)
-                if (p.active) activePos.push_back(p.pos);
-
-            // update VBO
-            glBindBuffer(GL_ARRAY_BUFFER, particleVBO);
-            glBufferData(GL_ARRAY_BUFFER,
-                activePos.size() * sizeof(glm::vec3),
-                activePos.data(), GL_STREAM_DRAW);
-
-            // render points
-            particleShader.use();
-            particleShader.setMat4("view", view);
-            particleShader.setMat4("projection", projection);
-            particleShader.setFloat("pointSize", 40.0f);
-            glBindVertexArray(particleVAO);
-            glDrawArrays(GL_POINTS, 0, activePos.size());
+        // debris, whichever path is active now: this frame's wrecks captured, the settling ones moved
+        // entirely on the GPU, and all of them drawn; the debris path's GPU time covers the three
+        if (!debris.empty()) {
+            ExplosionBenchmark& benchmark = explosionBenchmarks[(int)ExplosionPath::Debris];
+            benchmark.frames++;
+            benchmark.instances += debris.settling();  // exploding cars: captured this frame or still settling
+            SortKeyFields key = opaqueKey(debrisShader, debris.vertexArray(), carA.materialKey());
+            renderQueue.submit(key, [&debrisShader, &debris, &carA, &benchmark, debrisCaptureModel,
+                                     detonationBuffer, detonationOffset, detonations]() {
+                benchmark.timer.begin();
+                Shader& capture = debris.captureShader();
+                for (GLsizei i = 0; i < detonations && debris.beginCapture(); i++) {
+                    capture.setMat4(debrisCaptureModel, glm::mat4(1.0f));
+                    carA.DrawExplodedInstanced(detonationBuffer, detonationOffset + i * sizeof(InstanceData), 1);
+                    debris.endCapture();
+                }
+                debris.update(deltaTime);
+                debrisShader.use();
+                // the captured triangles no longer know their range, they all take the first material
+                if (!carA.getMaterials().empty())
+                    bindTextures(carA.getMaterials()[0].bindings);
+                debris.draw();
+                benchmark.timer.end();
+            });
         }
 
-        // draw Car B
-        basicShader.use();
-        basicShader.setMat4("view", view);
-        basicShader.setMat4("projection", projection);
-        glm::mat4 mb = glm::translate(glm::mat4(1.0f), carBPos);
-        mb = glm::rotate(mb, glm::radians(-carBYaw + 90.0f), glm::vec3(0, 1, 0));
-        mb = glm::scale(mb, glm::vec3(0.7f));
-        basicShader.setMat4("model", mb);
-        carModelB.Draw(basicShader);
+        // Car B
+        if (visible(carBCull)) {
+            Model& carB = drawable(carModelB);
+            unsigned int lod = selectLod(carBLod, carB, mb, 0.7f);
+            renderQueue.submit(opaqueKey(basicShader, carB.vertexArray(), carB.materialKey(), mb), [&basicShader, &carB, basicModel, mb, lod]() {
+                basicShader.use();
+                basicShader.setMat4(basicModel, mb);
+                carB.Draw(basicShader, lod);
+            });
+        }
+
+        // particles, blended after every opaque packet without writing depth, so they never hide each other
+        SortKeyFields particleKey;
+        particleKey.pass = SCENE_PASS;
+        particleKey.transparent = true;
+        if (particleBackend == ParticleBackend::Gpu) {
+            particleKey.program = particleGpuShader.ID;
+            renderQueue.submit(particleKey, [&particleGpuShader]() {
+                particleGpuShader.use();
+                glDepthMask(GL_FALSE);
+                gpuParticles->draw();
+                glDepthMask(GL_TRUE);
+            });
+        }
+        else if (particles.count) {
+            particleKey.program = particleShader.ID;
+            particleKey.vertexArray = particleVAO;
+            const std::vector<std::uint32_t>& order =
+                particleSorter.sort(particles, camPos, glm::normalize(target - camPos), CAMERA_FAR);
+            renderQueue.submit(particleKey, [&particleShader, &state, &order]() {
+                // positions go into mapped memory farthest first
+                StreamAllocation alloc = streamBuffer->allocate(
+                    order.size() * sizeof(glm::vec3), sizeof(glm::vec3));
+                if (!alloc.ptr)
+                    return;
+                size_t liveCount = particles.gatherPositions(order.data(), order.size(), (glm::vec3*)alloc.ptr);
+                streamBuffer->commit(alloc);
+
+                // render points
+                particleShader.use();
+                state.bindVertexArray(particleVAO);
+                glDepthMask(GL_FALSE);
+                glDrawArrays(GL_POINTS, (GLint)(alloc.offset / sizeof(glm::vec3)), (GLsizei)liveCount);
+                glDepthMask(GL_TRUE);
+            });
+        }
+
+        // clear, then run the packets in key order
+        glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        renderQueue.execute();
+
+        const CullingStats& culled = cullingBatch.stats();
+        std::size_t saved = renderQueue.stats().saved();
+        if (loader.idle() && (titleStale || culled.visible != titleStats.visible || culled.culled != titleStats.culled
+                || saved != titleSaved)) {
+            titleStale = false;
+            titleStats = culled;
+            titleSaved = saved;
+            std::string title = "Project - " + std::to_string(culled.visible) + " visible, "
+                + std::to_string(culled.culled) + " culled, " + std::to_string(saved) + " state changes saved by sorting";
+            glfwSetWindowTitle(window, title.c_str());
+        }
 
         // swap & poll
+        frameCount++;
+        queuedChanges += renderQueue.stats().stateChanges;
+        unsortedChanges += renderQueue.stats().unsortedStateChanges;
+        streamBuffer->endFrame();
         glfwSwapBuffers(window);
+        if (firstFrame) {
+            firstFrame = false;
+            startupLocationQueries = Shader::locationQueries();
+            std::cout << "First frame after " << glfwGetTime() * 1000.0 << " ms" << std::endl;
+        }
         glfwPollEvents();
     }
 
+    // uniform locations are all reflected at link time, rendering should never have asked for one
+    std::cout << "glGetUniformLocation calls: " << startupLocationQueries << " at startup, "
+        << Shader::locationQueries() - startupLocationQueries << " while rendering" << std::endl;
+
+    // redundant binds / program switches the state cache dropped
+    const GLStateStats& stateStats = state.stats();
+    std::cout << "GL state: " << stateStats.calls << " changes requested over " << frameCount << " frames, "
+        << stateStats.skipped << " redundant ones skipped ("
+        << (stateStats.calls ? 100.0 * stateStats.skipped / stateStats.calls : 0.0) << "%)";
+    if (state.validate)
+        std::cout << ", " << state.validationErrors() << " validation errors";
+    std::cout << std::endl;
+
+    // GPU cost of the explosions on each path that was used
+    for (int p = 0; p < (int)ExplosionPath::Count; p++)
+        reportExplosions((ExplosionPath)p);
+    if (debris.captured() || debris.dropped())
+        std::cout << "Debris: " << debris.captured() << " cars captured, " << debris.recycled() << " recycled to stay within "
+            << debris.capacity() << " vertices, " << debris.dropped() << " turned down (exploded on the vertex shader path), "
+            << debris.wreckCount() << " wrecks left, " << debris.passesPerUpdate() << " feedback passes per update" << std::endl;
+
+    // CPU particle depth sorts, from scratch vs. repaired from the previous frame's order
+    const ParticleSortStats& sortStats = particleSorter.stats();
+    if (sortStats.fullSorts + sortStats.repairs)
+        std::cout << "Particle sort: " << sortStats.fullSorts << " full ("
+            << (sortStats.fullSorts ? sortStats.fullMillis / sortStats.fullSorts : 0.0) << " ms avg, "
+            << particleSorter.threads() << " threads), " << sortStats.repairs << " repaired ("
+            << (sortStats.repairs ? sortStats.repairMillis / sortStats.repairs : 0.0) << " ms avg)" << std::endl;
+
+    // program / vertex array / material switches between consecutive packets, in submission vs. key order
+    if (frameCount)
+        std::cout << "Render queue: " << (double)queuedChanges / frameCount << " state changes per frame sorted, "
+            << (double)unsortedChanges / frameCount << " in submission order" << std::endl;
+
     // cleanup
+    state.forgetVertexArray(floorVAO);
+    state.forgetBuffer(floorVBO);
+    state.forgetVertexArray(particleVAO);
     glDeleteVertexArrays(1, &floorVAO);
     glDeleteBuffers(1, &floorVBO);
     glDeleteVertexArrays(1, &particleVAO);
-    glDeleteBuffers(1, &particleVBO);
-    glfwTerminate();
+    gpuParticles.reset();
+    streamBuffer.reset();
     return 0;
 }
 
-// initialize particle pool & VAO/VBO
+// initialize particle pool & VAO
 void initParticles() {
     particles.resize(MAX_PARTICLES);
-    for (auto& p : particles) {
-        p.active = false;
-        p.life = 0;
+    std::cout << "Particle update kernel: " << particleSimdName() << std::endl;
+    if (!verifyParticleKernels()) {
+        std::cout << "Particle kernels: SIMD results differ from the scalar path, using scalar" << std::endl;
+        particleKernel = ParticleKernel::Scalar;
     }
+    // positions are streamed every frame, the draw call's first vertex selects this frame's range
     glGenVertexArrays(1, &particleVAO);
-    glGenBuffers(1, &particleVBO);
-    glBindVertexArray(particleVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, particleVBO);
-    glBufferData(GL_ARRAY_BUFFER, MAX_PARTICLES * sizeof(glm::vec3), nullptr, GL_STREAM_DRAW);
+    glState().bindVertexArray(particleVAO);
+    glState().bindBuffer(GL_ARRAY_BUFFER, streamBuffer->buffer());
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+
+    gpuParticles = std::make_unique<GpuParticleSystem>(MAX_PARTICLES, "shader/particle_update.vs");
 }
 
 // spawn particles at explosion center
-void emitParticles(glm::vec3 center) {
-    for (auto& p : particles) {
-        p.active = true;
-        p.pos = center;
+// cost is proportional to the emitter budget; older debris is only stolen when the pool is full
+void emitParticles(glm::vec3 center, const ParticleEmitter& emitter) {
+    auto randomVelocity = []() {
         glm::vec3 d(distrib(generator),
             distrib(generator),
             distrib(generator));
             float speed = 2.0f + distrib(generator) * 3.0f;
-        p.velocity = glm::normalize(d) * speed;
-        p.life = 1.0f;
-    }
-}
+        return glm::normalize(d) * speed;
+    };
 
-// update particles each frame
-void updateParticles(float dt) {
-    for (auto& p : particles) {
-        if (!p.active) continue;
-        p.life -= dt;
-        if (p.life <= 0.0f) {
-            p.active = false;
-            continue;
-        }
-        p.velocity += glm::vec3(0.0f, -9.8f, 0.0f) * dt;
-        p.pos += p.velocity * dt;
+    if (particleBackend == ParticleBackend::Gpu) {
+        // the GPU ring overwrites its oldest particles itself, only the new ones are uploaded
+        gpuEmitStaging.resize(emitter.budget);
+        for (auto& p : gpuEmitStaging)
+            p = GpuParticle{ center, randomVelocity(), 1.0f };
+        gpuParticles->emit(gpuEmitStaging.data(), gpuEmitStaging.size());
+        return;
     }
+
+    ParticleRange range = particles.allocate(emitter);
+    for (size_t i = range.first; i < range.first + range.count; i++)
+        particles.set(i, center, randomVelocity(), 1.0f);
 }
 //
 // â ũ   Ʈ 
@@ -475,38 +938,61 @@ void processInput(GLFWwindow* window)
     }
 }
 
-// ؽó ε ƿƼ
-unsigned int loadTexture(const char* path)
-{
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-    int width, height, nrComponents;
-    unsigned char* data =
-        stbi_load(path, &width, &height, &nrComponents, 0);
-    if (data) {
-        GLenum format = (nrComponents == 1 ? GL_RED
-            : nrComponents == 3 ? GL_RGB
-            : GL_RGBA);
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format,
-            width, height, 0, format,
-            GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-        glTexParameteri(GL_TEXTURE_2D,
-            GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D,
-            GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D,
-            GL_TEXTURE_MIN_FILTER,
-            GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D,
-            GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        stbi_image_free(data);
+// parked Car A grid, rows running away from the play area behind the floor
+void initParkedCars() {
+    std::uniform_real_distribution<float> shade(0.4f, 1.0f);
+    parkedCars.resize(PARKED_CAR_COLUMNS * PARKED_CAR_ROWS);
+    parkedCarLod.assign(parkedCars.size(), LodSelector());
+    parkedCarSpread.assign(parkedCars.size(), 0);
+    for (int row = 0; row < PARKED_CAR_ROWS; row++) {
+        for (int column = 0; column < PARKED_CAR_COLUMNS; column++) {
+            InstanceData& car = parkedCars[row * PARKED_CAR_COLUMNS + column];
+            glm::vec3 position(
+                (column - PARKED_CAR_COLUMNS / 2) * PARKED_CAR_SPACING_X, 0.0f,
+                -15.0f - row * PARKED_CAR_SPACING_Z);
+            car.model = glm::scale(glm::translate(glm::mat4(1.0f), position), glm::vec3(0.7f));
+            car.tint = glm::vec4(shade(generator), shade(generator), shade(generator), 1.0f);
+        }
+    }
+}
+
+// parked cars explode on contact like Car A, then set off their neighbours one by one
+void updateParkedCars(const glm::vec3& ref, float currentTime) {
+    auto ignite = [currentTime](int column, int row, float start) {
+        if (column < 0 || column >= PARKED_CAR_COLUMNS || row < 0 || row >= PARKED_CAR_ROWS)
+            return false;
+        InstanceData& car = parkedCars[row * PARKED_CAR_COLUMNS + column];
+        if (car.params.x >= 0.0f)
+            return false;
+        car.params.x = start;
+        emitParticles(glm::vec3(car.model[3]), chainEmitter);
+        return true;
+    };
+
+    // the grid cell under the player
+    int column = (int)std::floor(ref.x / PARKED_CAR_SPACING_X + 0.5f) + PARKED_CAR_COLUMNS / 2;
+    int row = (int)std::floor((-15.0f - ref.z) / PARKED_CAR_SPACING_Z + 0.5f);
+    if (column >= 0 && column < PARKED_CAR_COLUMNS && row >= 0 && row < PARKED_CAR_ROWS) {
+        glm::vec3 position(parkedCars[row * PARKED_CAR_COLUMNS + column].model[3]);
+        if (glm::length(ref - position) < 1.5f && ignite(column, row, currentTime))
+            std::cout << "Parked car " << row * PARKED_CAR_COLUMNS + column << " set off a chain reaction" << std::endl;
     }
-    else {
-        std::cerr << "Failed to load texture at path: "
-            << path << std::endl;
-        stbi_image_free(data);
+
+    // Cars whose fuse ran out light their neighbours once, starting exactly one delay later. A flag rather
+    // than a one-frame age window, so frames longer than the delay (or cars lit late in this sweep with
+    // a start already in the past) still pass the fire on.
+    for (int r = 0; r < PARKED_CAR_ROWS; r++) {
+        for (int c = 0; c < PARKED_CAR_COLUMNS; c++) {
+            float start = parkedCars[r * PARKED_CAR_COLUMNS + c].params.x;
+            char& spread = parkedCarSpread[r * PARKED_CAR_COLUMNS + c];
+            if (start < 0.0f || spread || currentTime - start < CHAIN_REACTION_DELAY)
+                continue;
+            spread = 1;
+            float next = start + CHAIN_REACTION_DELAY;
+            ignite(c - 1, r, next);
+            ignite(c + 1, r, next);
+            ignite(c, r - 1, next);
+            ignite(c, r + 1, next);
+        }
     }
-    return textureID;
-}
\ No newline at end of file
+}
@@ -0,0 +1,269 @@
+#include <learnopengl/mesh_cache.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char MESH_CACHE_MAGIC[8] = "MESHBIN";
+
+std::string processedCachePath(const std::string& path, std::uint32_t processFlags, const char* extension) {
+    std::string suffix;
+    if (processFlags & MESH_PROCESS_OPTIMIZE)
+        suffix += 'o';
+    if (processFlags & MESH_PROCESS_LODS)
+        suffix += 'l';
+    return path + (suffix.empty() ? "" : "." + suffix) + extension;
+}
+
+std::string uniqueTempPath(const std::string& path) {
+    static std::atomic<unsigned int> counter(0);
+#ifdef _WIN32
+    unsigned long process = GetCurrentProcessId();
+#else
+    unsigned long process = (unsigned long)getpid();
+#endif
+    return path + "." + std::to_string(process) + "-" + std::to_string(counter++) + ".tmp";
+}
+
+bool writeFileReplacing(const std::string& path, const std::function<void(std::ostream&)>& write) {
+    std::string tmpPath = uniqueTempPath(path);
+    bool written;
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+        write(out);
+        out.close();
+        written = !out.fail();
+    }
+    if (written) {
+        std::remove(path.c_str());
+        if (std::rename(tmpPath.c_str(), path.c_str()) == 0)
+            return true;
+    }
+    std::remove(tmpPath.c_str());
+    return false;
+}
+
+MappedFile::MappedFile(const std::string& path) {
+#ifdef _WIN32
+    HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (f == INVALID_HANDLE_VALUE)
+        return;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(f, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(f);
+        return;
+    }
+    HANDLE m = CreateFileMappingA(f, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!m) {
+        CloseHandle(f);
+        return;
+    }
+    bytes = (const unsigned char*)MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+    length = (std::size_t)fileSize.QuadPart;
+    file = f;
+    mapping = m;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* p = mmap(nullptr, (std::size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            bytes = (const unsigned char*)p;
+            length = (std::size_t)st.st_size;
+        }
+    }
+    close(fd);
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+    if (bytes) UnmapViewOfFile(bytes);
+    if (mapping) CloseHandle(mapping);
+    if (file) CloseHandle(file);
+#else
+    if (bytes) munmap((void*)bytes, length);
+#endif
+}
+
+std::uint64_t hashFile(const std::string& path) {
+    MappedFile file(path);
+    if (!file)
+        return 0;
+    std::uint64_t h = 14695981039346656037ull;
+    for (std::size_t i = 0; i < file.size(); i++) {
+        h ^= file.data()[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// FNV-1a step over the bytes of value
+static std::uint64_t hashCombine(std::uint64_t h, std::uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        h ^= (value >> (8 * i)) & 0xff;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+std::uint64_t hashModelSources(const std::string& path) {
+    std::uint64_t h = hashFile(path);
+    std::string extension = path.substr(std::min(path.find_last_of('.'), path.size()));
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return (char)std::tolower((unsigned char)c); });
+    if (h == 0 || extension != ".obj")
+        return h;
+
+    // the rest of every "mtllib" line names a library relative to the model, as Assimp reads it
+    const std::string directory = path.substr(0, path.find_last_of('/') + 1);
+    MappedFile file(path);
+    const char* text = (const char*)file.data();
+    const char* end = text + file.size();
+    while (text < end) {
+        const char* lineEnd = std::find(text, end, '\n');
+        const char* p = text;
+        while (p < lineEnd && (*p == ' ' || *p == '\t'))
+            p++;
+        if (lineEnd - p > 7 && std::strncmp(p, "mtllib", 6) == 0 && (p[6] == ' ' || p[6] == '\t')) {
+            const char* name = p + 7;
+            const char* nameEnd = lineEnd;
+            while (name < nameEnd && (*name == ' ' || *name == '\t'))
+                name++;
+            while (nameEnd > name && std::isspace((unsigned char)nameEnd[-1]))
+                nameEnd--;
+            // a missing library hashes as 0, so creating it later invalidates too
+            h = hashCombine(h, hashFile(directory + std::string(name, nameEnd)));
+        }
+        text = lineEnd + 1;
+    }
+    return h;
+}
+
+bool openMeshCache(const MappedFile& file, std::uint64_t sourceHash, std::uint32_t importFlags, std::uint32_t processFlags,
+                   MeshCacheView& view) {
+    if (!file || file.size() < sizeof(MeshCacheHeader))
+        return false;
+    const MeshCacheHeader* h = (const MeshCacheHeader*)file.data();
+    if (std::memcmp(h->magic, MESH_CACHE_MAGIC, sizeof(h->magic)) != 0 || h->version != MESH_CACHE_VERSION
+        || h->vertexSize != sizeof(Vertex) || h->sourceHash != sourceHash || h->importFlags != importFlags
+        || h->processFlags != processFlags)
+        return false;
+
+    std::size_t tables = sizeof(MeshCacheHeader) + h->meshCount * sizeof(MeshCacheEntry)
+        + h->textureCount * sizeof(MeshCacheTexture);
+    if (file.size() < tables)
+        return false;
+
+    view.header = h;
+    view.base = file.data();
+    view.entries = (const MeshCacheEntry*)(file.data() + sizeof(MeshCacheHeader));
+    view.textures = (const MeshCacheTexture*)(view.entries + h->meshCount);
+    for (std::uint32_t i = 0; i < h->meshCount; i++) {
+        const MeshCacheEntry& e = view.entries[i];
+        if (e.vertexOffset + e.vertexCount * sizeof(Vertex) > file.size()
+            || e.indexOffset + e.indexCount * sizeof(unsigned int) > file.size()
+            || e.firstTexture + e.textureCount > h->textureCount
+            || e.detailIndexCount > e.indexCount || e.lodCount > MAX_MESH_LODS)
+            return false;
+    }
+    return true;
+}
+
+static std::uint64_t align16(std::uint64_t offset) {
+    return (offset + 15) & ~std::uint64_t(15);
+}
+
+bool writeMeshCache(const std::string& path, std::uint64_t sourceHash, std::uint32_t importFlags, std::uint32_t processFlags,
+                    float importMillis, const std::vector<MeshData>& meshes) {
+    MeshCacheHeader header = {};
+    std::memcpy(header.magic, MESH_CACHE_MAGIC, sizeof(header.magic));
+    header.version = MESH_CACHE_VERSION;
+    header.vertexSize = sizeof(Vertex);
+    header.sourceHash = sourceHash;
+    header.importFlags = importFlags;
+    header.processFlags = processFlags;
+    header.meshCount = (std::uint32_t)meshes.size();
+    header.importMillis = importMillis;
+
+    std::vector<MeshCacheEntry> entries(meshes.size(), MeshCacheEntry{});
+    std::vector<MeshCacheTexture> textures;
+    for (std::size_t i = 0; i < meshes.size(); i++) {
+        const MeshData& m = meshes[i];
+        MeshCacheEntry& e = entries[i];
+        e.vertexCount = m.vertexCount;
+        e.indexCount = m.totalIndexCount();
+        e.detailIndexCount = (std::uint32_t)m.indexCount;
+        e.lodCount = (std::uint32_t)std::min<std::size_t>(m.lods.size(), MAX_MESH_LODS);
+        for (std::uint32_t k = 0; k < e.lodCount; k++) {
+            e.lodFirstIndex[k] = (std::uint32_t)m.lods[k].firstIndex;
+            e.lodIndexCount[k] = (std::uint32_t)m.lods[k].indexCount;
+            e.lodError[k] = m.lods[k].error;
+        }
+        e.firstTexture = (std::uint32_t)textures.size();
+        e.textureCount = (std::uint32_t)m.textures.size();
+        e.attributes = m.available;
+        for (int k = 0; k < 3; k++) {
+            e.boundsMin[k] = m.boundsMin[k];
+            e.boundsMax[k] = m.boundsMax[k];
+            e.sphere[k] = m.sphere.center[k];
+        }
+        e.sphere[3] = m.sphere.radius;
+        for (const TextureRef& t : m.textures) {
+            MeshCacheTexture ct = {};
+            // the type is stored by name, so the enum can change without invalidating caches
+            const char* type = textureTypeName(t.type);
+            if (std::strlen(type) >= sizeof(ct.type) || t.path.size() >= sizeof(ct.path)) {
+                std::cout << "MESH_CACHE::texture path too long, not caching " << path << std::endl;
+                return false;
+            }
+            std::memcpy(ct.type, type, std::strlen(type));
+            std::memcpy(ct.path, t.path.c_str(), t.path.size());
+            textures.push_back(ct);
+        }
+    }
+    header.textureCount = (std::uint32_t)textures.size();
+
+    std::uint64_t offset = sizeof(MeshCacheHeader) + entries.size() * sizeof(MeshCacheEntry)
+        + textures.size() * sizeof(MeshCacheTexture);
+    for (MeshCacheEntry& e : entries) {
+        e.vertexOffset = offset = align16(offset);
+        offset += e.vertexCount * sizeof(Vertex);
+        e.indexOffset = offset = align16(offset);
+        offset += e.indexCount * sizeof(unsigned int);
+    }
+
+    return writeFileReplacing(path, [&](std::ostream& out) {
+        out.write((const char*)&header, sizeof(header));
+        out.write((const char*)entries.data(), entries.size() * sizeof(MeshCacheEntry));
+        out.write((const char*)textures.data(), textures.size() * sizeof(MeshCacheTexture));
+        static const char zeros[16] = {};
+        std::uint64_t written = (std::uint64_t)out.tellp();
+        for (std::size_t i = 0; i < meshes.size(); i++) {
+            out.write(zeros, entries[i].vertexOffset - written);
+            out.write((const char*)meshes[i].vertexData(), entries[i].vertexCount * sizeof(Vertex));
+            written = entries[i].vertexOffset + entries[i].vertexCount * sizeof(Vertex);
+            out.write(zeros, entries[i].indexOffset - written);
+            out.write((const char*)meshes[i].indexData(), entries[i].indexCount * sizeof(unsigned int));
+            written = entries[i].indexOffset + entries[i].indexCount * sizeof(unsigned int);
+        }
+    });
+}
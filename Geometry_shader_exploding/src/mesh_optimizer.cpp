@@ -0,0 +1,296 @@
+#include <learnopengl/mesh_optimizer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+// Forsyth's scoring constants, tuned for an LRU cache of 32 entries
+static const int   FORSYTH_CACHE_SIZE = 32;
+static const float CACHE_DECAY_POWER = 1.5f;
+static const float LAST_TRIANGLE_SCORE = 0.75f;
+static const float VALENCE_BOOST_SCALE = 2.0f;
+static const float VALENCE_BOOST_POWER = 0.5f;
+
+static const std::size_t NO_TRIANGLE = ~(std::size_t)0;
+
+VertexCacheStats analyzeVertexCache(const unsigned int* indices, std::size_t indexCount, std::size_t vertexCount,
+                                    unsigned int cacheSize) {
+    // a vertex is still cached while fewer than cacheSize misses happened since it was loaded
+    std::vector<unsigned int> loadedAt(vertexCount, 0);
+    unsigned int time = cacheSize + 1;
+    std::size_t misses = 0, referenced = 0;
+    for (std::size_t i = 0; i < indexCount; i++) {
+        unsigned int v = indices[i];
+        if (loadedAt[v] == 0)
+            referenced++;
+        if (time - loadedAt[v] > cacheSize) {
+            loadedAt[v] = time++;
+            misses++;
+        }
+    }
+
+    VertexCacheStats stats;
+    stats.acmr = indexCount >= 3 ? (float)misses / (indexCount / 3) : 0.0f;
+    stats.atvr = referenced ? (float)misses / referenced : 0.0f;
+    return stats;
+}
+
+void weldVertices(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    // vertices are compared byte for byte (processMesh zero-initializes them, so there is no stale data)
+    struct Hash {
+        const Vertex* v;
+        std::size_t operator()(unsigned int i) const {
+            const unsigned char* bytes = (const unsigned char*)&v[i];
+            std::uint64_t h = 14695981039346656037ull;
+            for (std::size_t k = 0; k < sizeof(Vertex); k++) {
+                h ^= bytes[k];
+                h *= 1099511628211ull;
+            }
+            return (std::size_t)h;
+        }
+    };
+    struct Equal {
+        const Vertex* v;
+        bool operator()(unsigned int a, unsigned int b) const { return std::memcmp(&v[a], &v[b], sizeof(Vertex)) == 0; }
+    };
+
+    std::unordered_map<unsigned int, unsigned int, Hash, Equal> firstCopy(
+        vertices.size(), Hash{ vertices.data() }, Equal{ vertices.data() });
+    std::vector<unsigned int> remap(vertices.size());
+    std::vector<Vertex> welded;
+    welded.reserve(vertices.size());
+    for (unsigned int i = 0; i < (unsigned int)vertices.size(); i++) {
+        auto inserted = firstCopy.emplace(i, (unsigned int)welded.size());
+        if (inserted.second)
+            welded.push_back(vertices[i]);
+        remap[i] = inserted.first->second;
+    }
+
+    for (unsigned int& index : indices)
+        index = remap[index];
+    vertices.swap(welded);
+}
+
+static float forsythScore(int cachePosition, unsigned int valence) {
+    if (valence == 0)
+        return -1.0f;  // no triangles left, never worth keeping
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3)
+            score = LAST_TRIANGLE_SCORE;  // used by the last triangle, fixed so the next one does not just reuse its edge
+        else
+            score = std::pow(1.0f - (cachePosition - 3) / (float)(FORSYTH_CACHE_SIZE - 3), CACHE_DECAY_POWER);
+    }
+    // favors vertices with few triangles left so they are finished off instead of becoming stragglers
+    return score + VALENCE_BOOST_SCALE * std::pow((float)valence, -VALENCE_BOOST_POWER);
+}
+
+void optimizeVertexCache(std::vector<unsigned int>& indices, std::size_t vertexCount) {
+    const std::size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0)
+        return;
+
+    // triangles of vertex v not emitted yet: adjacency[offsets[v], offsets[v] + valence[v])
+    std::vector<unsigned int> valence(vertexCount, 0);
+    for (unsigned int v : indices)
+        valence[v]++;
+    std::vector<unsigned int> offsets(vertexCount + 1, 0);
+    for (std::size_t v = 0; v < vertexCount; v++)
+        offsets[v + 1] = offsets[v] + valence[v];
+    std::vector<unsigned int> adjacency(indices.size());
+    {
+        std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+        for (std::size_t i = 0; i < indices.size(); i++)
+            adjacency[fill[indices[i]]++] = (unsigned int)(i / 3);
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (std::size_t v = 0; v < vertexCount; v++)
+        vertexScore[v] = forsythScore(-1, valence[v]);
+
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<char> emitted(triangleCount, 0);
+    std::size_t best = 0;
+    for (std::size_t t = 0; t < triangleCount; t++) {
+        triangleScore[t] = vertexScore[indices[3 * t]] + vertexScore[indices[3 * t + 1]] + vertexScore[indices[3 * t + 2]];
+        if (triangleScore[t] > triangleScore[best])
+            best = t;
+    }
+
+    std::vector<unsigned int> cache, grown;
+    cache.reserve(FORSYTH_CACHE_SIZE + 3);
+    grown.reserve(FORSYTH_CACHE_SIZE + 3);
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+    std::size_t cursor = 0;  // no triangle before it is left, for restarts when the cache has nothing to offer
+
+    for (;;) {
+        if (best == NO_TRIANGLE) {
+            while (cursor < triangleCount && emitted[cursor])
+                cursor++;
+            if (cursor == triangleCount)
+                break;
+            best = cursor;
+        }
+
+        emitted[best] = 1;
+        const unsigned int* tri = &indices[3 * best];
+        result.insert(result.end(), tri, tri + 3);
+        for (int k = 0; k < 3; k++) {
+            unsigned int v = tri[k];
+            unsigned int* begin = &adjacency[offsets[v]];
+            unsigned int* end = begin + valence[v];
+            std::iter_swap(std::find(begin, end, (unsigned int)best), end - 1);
+            valence[v]--;
+        }
+
+        // LRU update: the triangle's vertices move to the front
+        grown.clear();
+        for (int k = 0; k < 3; k++) {
+            if (std::find(grown.begin(), grown.end(), tri[k]) == grown.end())
+                grown.push_back(tri[k]);
+        }
+        for (unsigned int v : cache) {
+            if (v != tri[0] && v != tri[1] && v != tri[2])
+                grown.push_back(v);
+        }
+
+        // rescore everything that moved (including vertices just evicted) and the triangles around them
+        for (std::size_t i = 0; i < grown.size(); i++) {
+            unsigned int v = grown[i];
+            cachePosition[v] = i < (std::size_t)FORSYTH_CACHE_SIZE ? (int)i : -1;
+            float score = forsythScore(cachePosition[v], valence[v]);
+            float delta = score - vertexScore[v];
+            vertexScore[v] = score;
+            for (unsigned int a = offsets[v]; a < offsets[v] + valence[v]; a++)
+                triangleScore[adjacency[a]] += delta;
+        }
+        grown.resize(std::min(grown.size(), (std::size_t)FORSYTH_CACHE_SIZE));
+        cache.swap(grown);
+
+        // next triangle: the best one touching the cache
+        best = NO_TRIANGLE;
+        float bestScore = -1.0f;
+        for (unsigned int v : cache) {
+            for (unsigned int a = offsets[v]; a < offsets[v] + valence[v]; a++) {
+                unsigned int t = adjacency[a];
+                if (triangleScore[t] > bestScore) {
+                    bestScore = triangleScore[t];
+                    best = t;
+                }
+            }
+        }
+    }
+
+    indices.swap(result);
+}
+
+void optimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<Vertex>& vertices, float threshold) {
+    const std::size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2)
+        return;
+
+    // The cache order is cut into clusters wherever it jumps elsewhere (all three vertices miss).
+    // Clusters can be reordered freely without hurting the cache much.
+    std::vector<std::size_t> clusterStart;
+    {
+        std::vector<unsigned int> loadedAt(vertices.size(), 0);
+        unsigned int time = VERTEX_CACHE_SIZE + 1;
+        for (std::size_t t = 0; t < triangleCount; t++) {
+            int misses = 0;
+            for (int k = 0; k < 3; k++) {
+                unsigned int v = indices[3 * t + k];
+                if (time - loadedAt[v] > VERTEX_CACHE_SIZE) {
+                    loadedAt[v] = time++;
+                    misses++;
+                }
+            }
+            if (t == 0 || misses == 3)
+                clusterStart.push_back(t);
+        }
+    }
+    if (clusterStart.size() < 2)
+        return;
+    clusterStart.push_back(triangleCount);
+
+    struct Cluster {
+        std::size_t first, last;
+        glm::vec3 centroid, normal;  // area weighted
+        float area;
+        float key;
+    };
+    std::vector<Cluster> clusters;
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+    for (std::size_t c = 0; c + 1 < clusterStart.size(); c++) {
+        Cluster cluster{ clusterStart[c], clusterStart[c + 1], glm::vec3(0.0f), glm::vec3(0.0f), 0.0f, 0.0f };
+        for (std::size_t t = cluster.first; t < cluster.last; t++) {
+            const glm::vec3& a = vertices[indices[3 * t]].Position;
+            const glm::vec3& b = vertices[indices[3 * t + 1]].Position;
+            const glm::vec3& d = vertices[indices[3 * t + 2]].Position;
+            glm::vec3 n = glm::cross(b - a, d - a);
+            float area = glm::length(n);
+            cluster.normal += n;
+            cluster.centroid += (a + b + d) * (area / 3.0f);
+            cluster.area += area;
+        }
+        meshCentroid += cluster.centroid;
+        meshArea += cluster.area;
+        if (cluster.area > 0.0f)
+            cluster.centroid /= cluster.area;
+        clusters.push_back(cluster);
+    }
+    if (meshArea > 0.0f)
+        meshCentroid /= meshArea;
+
+    // clusters far out along their own normal are likely on the silhouette and drawn first
+    for (Cluster& cluster : clusters) {
+        float length = glm::length(cluster.normal);
+        cluster.key = length > 0.0f ? glm::dot(cluster.centroid - meshCentroid, cluster.normal / length) : 0.0f;
+    }
+    std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) { return a.key > b.key; });
+
+    std::vector<unsigned int> sorted;
+    sorted.reserve(indices.size());
+    for (const Cluster& cluster : clusters)
+        sorted.insert(sorted.end(), indices.begin() + 3 * cluster.first, indices.begin() + 3 * cluster.last);
+
+    float before = analyzeVertexCache(indices.data(), indices.size(), vertices.size()).acmr;
+    float after = analyzeVertexCache(sorted.data(), sorted.size(), vertices.size()).acmr;
+    if (after <= before * threshold)
+        indices.swap(sorted);
+}
+
+void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    const unsigned int unused = ~0u;
+    std::vector<unsigned int> remap(vertices.size(), unused);
+    std::vector<Vertex> ordered;
+    ordered.reserve(vertices.size());
+    for (unsigned int& index : indices) {
+        if (remap[index] == unused) {
+            remap[index] = (unsigned int)ordered.size();
+            ordered.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+    vertices.swap(ordered);
+}
+
+MeshOptimizationReport optimizeMesh(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    MeshOptimizationReport report;
+    report.verticesBefore = vertices.size();
+    report.before = analyzeVertexCache(indices.data(), indices.size(), vertices.size());
+
+    weldVertices(vertices, indices);
+    optimizeVertexCache(indices, vertices.size());
+    optimizeOverdraw(indices, vertices);
+    optimizeVertexFetch(vertices, indices);
+
+    report.verticesAfter = vertices.size();
+    report.after = analyzeVertexCache(indices.data(), indices.size(), vertices.size());
+    return report;
+}
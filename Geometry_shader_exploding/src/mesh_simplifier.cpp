@@ -0,0 +1,290 @@
+#include <learnopengl/mesh_simplifier.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+
+// borders are kept in place by planes through each border edge, perpendicular to its triangle
+static const double BORDER_WEIGHT = 10.0;
+static const int MAX_PASSES = 100;
+
+static const unsigned char GROUP_BORDER = 1 << 0;  // touches an edge used by one triangle
+static const unsigned char GROUP_LOCKED = 1 << 1;  // touches an edge used by more than two triangles
+
+// symmetric 4x4 matrix of summed squared plane distances, plus the total weight for normalization
+struct Quadric {
+    double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+    double a11 = 0, a12 = 0, a13 = 0;
+    double a22 = 0, a23 = 0;
+    double a33 = 0;
+    double weight = 0;
+
+    void addPlane(const glm::dvec3& n, double d, double w) {
+        a00 += w * n.x * n.x; a01 += w * n.x * n.y; a02 += w * n.x * n.z; a03 += w * n.x * d;
+        a11 += w * n.y * n.y; a12 += w * n.y * n.z; a13 += w * n.y * d;
+        a22 += w * n.z * n.z; a23 += w * n.z * d;
+        a33 += w * d * d;
+        weight += w;
+    }
+
+    void add(const Quadric& q) {
+        a00 += q.a00; a01 += q.a01; a02 += q.a02; a03 += q.a03;
+        a11 += q.a11; a12 += q.a12; a13 += q.a13;
+        a22 += q.a22; a23 += q.a23;
+        a33 += q.a33;
+        weight += q.weight;
+    }
+
+    // mean squared distance of p to the accumulated planes
+    double error(const glm::vec3& p) const {
+        double x = p.x, y = p.y, z = p.z;
+        double e = a00 * x * x + 2 * a01 * x * y + 2 * a02 * x * z + 2 * a03 * x
+                 + a11 * y * y + 2 * a12 * y * z + 2 * a13 * y
+                 + a22 * z * z + 2 * a23 * z
+                 + a33;
+        return weight > 0 ? std::max(e, 0.0) / weight : 0.0;
+    }
+};
+
+struct Collapse {
+    unsigned int from, to;  // position groups
+    double cost;
+};
+
+static std::uint64_t edgeKey(unsigned int a, unsigned int b) {
+    if (a > b) std::swap(a, b);
+    return ((std::uint64_t)a << 32) | b;
+}
+
+float simplifyMesh(const Vertex* vertices, std::size_t vertexCount, const unsigned int* indices, std::size_t indexCount,
+                   std::size_t targetIndexCount, std::vector<unsigned int>& out) {
+    out.assign(indices, indices + indexCount);
+    if (indexCount <= targetIndexCount || vertexCount == 0)
+        return 0.0f;
+
+    // Vertices at the same position (split by UVs or normals) form one group; group[v] is its first vertex
+    // and wedgeNext links all vertices of a group in a ring.
+    std::vector<unsigned int> group(vertexCount), wedgeNext(vertexCount);
+    {
+        struct PositionHash {
+            std::size_t operator()(const glm::vec3& p) const {
+                glm::vec3 q = p + glm::vec3(0.0f);  // -0 and +0 compare equal, so they must hash equal
+                std::uint32_t h[3];
+                std::memcpy(h, &q, sizeof(h));
+                return (std::size_t)(h[0] * 73856093u ^ h[1] * 19349663u ^ h[2] * 83492791u);
+            }
+        };
+        std::unordered_map<glm::vec3, unsigned int, PositionHash> firstAt(vertexCount);
+        for (unsigned int v = 0; v < (unsigned int)vertexCount; v++) {
+            unsigned int first = firstAt.emplace(vertices[v].Position, v).first->second;
+            group[v] = first;
+            wedgeNext[v] = v;
+            if (first != v) {
+                wedgeNext[v] = wedgeNext[first];
+                wedgeNext[first] = v;
+            }
+        }
+    }
+    auto position = [vertices](unsigned int v) { return vertices[v].Position; };
+
+    // area weighted face planes, border planes on open edges
+    std::vector<Quadric> quadrics(vertexCount);
+    {
+        std::unordered_map<std::uint64_t, unsigned int> edgeUse;
+        for (std::size_t i = 0; i < indexCount; i += 3) {
+            for (int k = 0; k < 3; k++)
+                edgeUse[edgeKey(group[indices[i + k]], group[indices[i + (k + 1) % 3]])]++;
+        }
+        for (std::size_t i = 0; i < indexCount; i += 3) {
+            glm::dvec3 p[3] = { position(indices[i]), position(indices[i + 1]), position(indices[i + 2]) };
+            glm::dvec3 n = glm::cross(p[1] - p[0], p[2] - p[0]);
+            double length = glm::length(n);
+            if (length == 0.0)
+                continue;
+            n /= length;
+            for (int k = 0; k < 3; k++)
+                quadrics[group[indices[i + k]]].addPlane(n, -glm::dot(n, p[0]), length * 0.5);
+
+            for (int k = 0; k < 3; k++) {
+                unsigned int a = group[indices[i + k]], b = group[indices[i + (k + 1) % 3]];
+                if (edgeUse[edgeKey(a, b)] != 1)
+                    continue;
+                glm::dvec3 edge = p[(k + 1) % 3] - p[k];
+                glm::dvec3 m = glm::cross(edge, n);
+                double edgeLength = glm::length(m);
+                if (edgeLength == 0.0)
+                    continue;
+                m /= edgeLength;
+                double w = BORDER_WEIGHT * edgeLength * edgeLength;
+                quadrics[a].addPlane(m, -glm::dot(m, p[k]), w);
+                quadrics[b].addPlane(m, -glm::dot(m, p[k]), w);
+            }
+        }
+    }
+
+    double maxError = 0.0;
+    std::vector<unsigned int> collapse(vertexCount);
+    std::vector<char> touched(vertexCount);
+    std::vector<unsigned char> groupFlags(vertexCount);
+    std::vector<unsigned int> adjacencyOffsets(vertexCount + 1), adjacency;
+    std::vector<std::pair<unsigned int, unsigned int>> wedgeMap;
+    std::vector<Collapse> candidates;
+
+    // triangles of vertex v in the current index buffer
+    auto trianglesOf = [&](unsigned int v, const unsigned int*& begin, const unsigned int*& end) {
+        begin = adjacency.data() + adjacencyOffsets[v];
+        end = adjacency.data() + adjacencyOffsets[v + 1];
+    };
+
+    // every wedge of `from` needs a wedge of `to` it shares an edge with; that is where it collapses to
+    auto matchWedges = [&](unsigned int from, unsigned int to) {
+        wedgeMap.clear();
+        unsigned int w = from;
+        do {
+            const unsigned int *t, *tEnd;
+            trianglesOf(w, t, tEnd);
+            if (t != tEnd) {
+                unsigned int match = ~0u;
+                for (; t != tEnd && match == ~0u; ++t) {
+                    for (int k = 0; k < 3; k++) {
+                        if (group[out[3 * *t + k]] == to)
+                            match = out[3 * *t + k];
+                    }
+                }
+                if (match == ~0u)
+                    return false;
+                wedgeMap.emplace_back(w, match);
+            }
+            w = wedgeNext[w];
+        } while (w != from);
+        return true;
+    };
+
+    // moving `from` onto `to` must not turn any surviving triangle around
+    auto flips = [&](unsigned int from, unsigned int to) {
+        const glm::vec3 target = position(to);
+        unsigned int w = from;
+        do {
+            const unsigned int *t, *tEnd;
+            for (trianglesOf(w, t, tEnd); t != tEnd; ++t) {
+                const unsigned int* tri = &out[3 * *t];
+                if (group[tri[0]] == to || group[tri[1]] == to || group[tri[2]] == to)
+                    continue;  // collapses away
+                glm::vec3 p[3] = { position(tri[0]), position(tri[1]), position(tri[2]) };
+                glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+                for (int k = 0; k < 3; k++) {
+                    if (group[tri[k]] == from)
+                        p[k] = target;
+                }
+                glm::vec3 after = glm::cross(p[1] - p[0], p[2] - p[0]);
+                if (glm::dot(before, after) <= 0.0f)
+                    return true;
+            }
+            w = wedgeNext[w];
+        } while (w != from);
+        return false;
+    };
+
+    for (int pass = 0; pass < MAX_PASSES && out.size() > targetIndexCount; pass++) {
+        const std::size_t triangleCount = out.size() / 3;
+
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+        for (unsigned int v : out)
+            adjacencyOffsets[v + 1]++;
+        for (std::size_t v = 0; v < vertexCount; v++)
+            adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+        adjacency.resize(out.size());
+        {
+            std::vector<unsigned int> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (std::size_t i = 0; i < out.size(); i++)
+                adjacency[fill[out[i]]++] = (unsigned int)(i / 3);
+        }
+
+        std::unordered_map<std::uint64_t, unsigned int> edgeUse;
+        for (std::size_t t = 0; t < triangleCount; t++) {
+            for (int k = 0; k < 3; k++)
+                edgeUse[edgeKey(group[out[3 * t + k]], group[out[3 * t + (k + 1) % 3]])]++;
+        }
+        std::fill(groupFlags.begin(), groupFlags.end(), 0);
+        for (const auto& e : edgeUse) {
+            unsigned char flag = e.second == 1 ? GROUP_BORDER : e.second > 2 ? GROUP_LOCKED : 0;
+            groupFlags[e.first >> 32] |= flag;
+            groupFlags[e.first & 0xffffffffu] |= flag;
+        }
+
+        // cheapest valid direction of every edge
+        candidates.clear();
+        for (const auto& e : edgeUse) {
+            unsigned int ends[2] = { (unsigned int)(e.first >> 32), (unsigned int)(e.first & 0xffffffffu) };
+            Collapse best = { 0, 0, -1.0 };
+            for (int d = 0; d < 2; d++) {
+                unsigned int from = ends[d], to = ends[1 - d];
+                if (from == to || (groupFlags[from] & GROUP_LOCKED))
+                    continue;
+                if ((groupFlags[from] & GROUP_BORDER) && e.second != 1)
+                    continue;  // border vertices only slide along the border
+                double cost = quadrics[from].error(position(to));
+                if (best.cost < 0.0 || cost < best.cost)
+                    best = Collapse{ from, to, cost };
+            }
+            if (best.cost >= 0.0)
+                candidates.push_back(best);
+        }
+        if (candidates.empty())
+            break;
+        std::sort(candidates.begin(), candidates.end(), [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+        // each collapse removes about two triangles; stop early on edges much worse than the goal needs
+        std::size_t goal = std::max<std::size_t>((out.size() - targetIndexCount) / 6, 1);
+        double limit = candidates[std::min(goal, candidates.size() - 1)].cost * 1.5;
+
+        for (unsigned int v = 0; v < (unsigned int)vertexCount; v++)
+            collapse[v] = v;
+        std::fill(touched.begin(), touched.end(), 0);
+        std::size_t collapses = 0;
+        for (const Collapse& c : candidates) {
+            if (collapses >= goal || c.cost > limit)
+                break;
+            if (touched[c.from] || touched[c.to])
+                continue;
+            if (!matchWedges(c.from, c.to) || flips(c.from, c.to))
+                continue;
+
+            for (const auto& m : wedgeMap)
+                collapse[m.first] = m.second;
+            quadrics[c.to].add(quadrics[c.from]);
+            maxError = std::max(maxError, c.cost);
+            collapses++;
+
+            // neighbours keep their positions for the rest of the pass, so the flip test above stays valid
+            unsigned int w = c.from;
+            do {
+                const unsigned int *t, *tEnd;
+                for (trianglesOf(w, t, tEnd); t != tEnd; ++t) {
+                    for (int k = 0; k < 3; k++)
+                        touched[group[out[3 * *t + k]]] = 1;
+                }
+                w = wedgeNext[w];
+            } while (w != c.from);
+            touched[c.to] = 1;
+        }
+        if (collapses == 0)
+            break;
+
+        std::size_t write = 0;
+        for (std::size_t t = 0; t < triangleCount; t++) {
+            unsigned int a = collapse[out[3 * t]], b = collapse[out[3 * t + 1]], c = collapse[out[3 * t + 2]];
+            if (group[a] == group[b] || group[b] == group[c] || group[a] == group[c])
+                continue;
+            out[write++] = a;
+            out[write++] = b;
+            out[write++] = c;
+        }
+        out.resize(write);
+    }
+
+    return (float)std::sqrt(maxError);
+}
@@ -1,43 +1,191 @@
 #include <learnopengl/model.h> 
+#include <learnopengl/asset_manager.h>
+#include <learnopengl/fracture.h>
+#include <learnopengl/mesh_cache.h>
+#include <learnopengl/mesh_optimizer.h>
+#include <learnopengl/mesh_simplifier.h>
 #include <stb_image.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <iostream>
 
-void Model::Draw(Shader& shader) {
-    for (auto& mesh : meshes)
-        mesh.Draw(shader);
+// undo AABB quantization of positions (identity for float positions); the handles are resolved once per program
+void Model::setLayoutUniforms(const Shader& shader) {
+    auto cached = std::find_if(layoutUniforms.begin(), layoutUniforms.end(),
+        [&shader](const LayoutUniforms& u) { return u.program == shader.ID; });
+    if (cached == layoutUniforms.end()) {
+        layoutUniforms.push_back(LayoutUniforms{ shader.ID, shader.uniform("positionOffset"), shader.uniform("positionScale") });
+        cached = layoutUniforms.end() - 1;
+    }
+    shader.setVec3(cached->offset, layout.positionOffset);
+    shader.setVec3(cached->scale, layout.positionScale);
 }
 
-void Model::loadModel(std::string const& path) {
-    Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs);
+void Model::Draw(Shader& shader, unsigned int lod) {
+    if (ranges.empty())
+        return;
 
-    if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
-        std::cout << "ERROR::ASSIMP::" << importer.GetErrorString() << std::endl;
+    setLayoutUniforms(shader);
+
+    const GLsizeiptr indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int);
+    const unsigned int noMaterial = ~0u;
+    unsigned int boundMaterial = noMaterial;
+    glState().bindVertexArray(VAO);
+    for (const DrawRange& range : ranges) {
+        if (range.material != boundMaterial) {
+            bindTextures(materials[range.material].bindings);
+            boundMaterial = range.material;
+        }
+        IndexRange level = range.level(lod);
+        glDrawElementsBaseVertex(GL_TRIANGLES, level.indexCount, indexType,
+            (void*)(level.firstIndex * indexSize), range.baseVertex);
+    }
+    // the VAO and textures stay bound, the state cache skips rebinding them for the next instance
+}
+
+void Model::DrawInstanced(Shader& shader, GLuint instanceBuffer, GLintptr instanceOffset, GLsizei instanceCount,
+                          unsigned int lod) {
+    if (ranges.empty() || instanceCount <= 0)
         return;
+
+    setLayoutUniforms(shader);
+
+    const GLsizeiptr indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int);
+    const unsigned int noMaterial = ~0u;
+    unsigned int boundMaterial = noMaterial;
+    glState().bindVertexArray(VAO);
+    enableInstanceAttributes(instanceBuffer, instanceOffset);
+    for (const DrawRange& range : ranges) {
+        if (range.material != boundMaterial) {
+            bindTextures(materials[range.material].bindings);
+            boundMaterial = range.material;
+        }
+        IndexRange level = range.level(lod);
+        glDrawElementsInstancedBaseVertex(GL_TRIANGLES, level.indexCount, indexType,
+            (void*)(level.firstIndex * indexSize), instanceCount, range.baseVertex);
     }
-    directory = path.substr(0, path.find_last_of('/'));
+    // the VAO is shared with plain Draw calls (and other owners of the model)
+    disableInstanceAttributes();
+}
+
+void Model::DrawExplodedInstanced(GLuint instanceBuffer, GLintptr instanceOffset, GLsizei instanceCount) {
+    if (!explodable() || instanceCount <= 0)
+        return;
 
-    processNode(scene->mRootNode, scene);
+    unsigned int boundMaterial = ~0u;
+    glState().bindVertexArray(explodeVAO);
+    enableInstanceAttributes(instanceBuffer, instanceOffset);
+    for (const DrawRange& range : ranges) {
+        if (range.explodeCount == 0)
+            continue;
+        if (range.material != boundMaterial) {
+            bindTextures(materials[range.material].bindings);
+            boundMaterial = range.material;
+        }
+        glDrawArraysInstanced(GL_TRIANGLES, range.explodeFirst, range.explodeCount, instanceCount);
+    }
+    disableInstanceAttributes();
 }
 
-void Model::processNode(aiNode* node, const aiScene* scene) {
-    for (unsigned int i = 0; i < node->mNumMeshes; i++) {
-        aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-        meshes.push_back(processMesh(mesh, scene));
+void Model::bindDestruction(Shader& shader, UniformHandle fps) const {
+    if (!hasDestruction())
+        return;
+    glState().bindTexture(DESTRUCTION_TEXTURE_UNIT, destructionTexture);
+    shader.setFloat(fps, destructionFps);
+}
+
+static const unsigned int MODEL_IMPORT_FLAGS = aiProcess_Triangulate | aiProcess_FlipUVs;
+
+// maps a .meshbin and points the mesh data straight into it, so nothing is copied before the upload
+static bool loadMeshCache(const std::string& cachePath, std::uint64_t sourceHash, std::uint32_t processFlags,
+                          ModelData& data, float& importMillis) {
+    auto file = std::make_shared<const MappedFile>(cachePath);
+    MeshCacheView view;
+    if (!openMeshCache(*file, sourceHash, MODEL_IMPORT_FLAGS, processFlags, view))
+        return false;
+
+    for (std::uint32_t i = 0; i < view.header->meshCount; i++) {
+        const MeshCacheEntry& e = view.entries[i];
+        MeshData mesh;
+        mesh.mappedVertices = view.vertices(e);
+        mesh.mappedIndices = view.indices(e);
+        mesh.vertexCount = (std::size_t)e.vertexCount;
+        mesh.indexCount = e.detailIndexCount;
+        for (std::uint32_t k = 0; k < e.lodCount; k++)
+            mesh.lods.push_back(MeshLod{ e.lodFirstIndex[k], e.lodIndexCount[k], e.lodError[k] });
+        for (std::uint32_t t = e.firstTexture; t < e.firstTexture + e.textureCount; t++)
+            mesh.textures.push_back(TextureRef{ view.textures[t].path, textureTypeFromName(view.textures[t].type) });
+        mesh.available = e.attributes;
+        mesh.boundsMin = glm::vec3(e.boundsMin[0], e.boundsMin[1], e.boundsMin[2]);
+        mesh.boundsMax = glm::vec3(e.boundsMax[0], e.boundsMax[1], e.boundsMax[2]);
+        mesh.sphere = BoundingSphere{ glm::vec3(e.sphere[0], e.sphere[1], e.sphere[2]), e.sphere[3] };
+        data.meshes.push_back(std::move(mesh));
     }
+    data.cache = std::move(file);
+    importMillis = view.header->importMillis;
+    return true;
+}
 
-    for (unsigned int i = 0; i < node->mNumChildren; i++) {
-        processNode(node->mChildren[i], scene);
+static void loadMaterialTextures(aiMaterial* mat, aiTextureType type, TextureType textureType, std::vector<TextureRef>& textures) {
+    for (unsigned int i = 0; i < mat->GetTextureCount(type); i++) {
+        aiString str;
+        mat->GetTexture(type, i, &str);
+        textures.push_back(TextureRef{ str.C_Str(), textureType });
+    }
+}
+
+// Ritter's bounding sphere: start from the most distant pair of axis extremes, grow to include outliers.
+// Within about 5-20% of the minimal sphere and usually much tighter than the AABB's circumsphere.
+static BoundingSphere computeBoundingSphere(const std::vector<Vertex>& vertices) {
+    if (vertices.empty())
+        return BoundingSphere{ glm::vec3(0.0f), 0.0f };
+
+    std::size_t minIndex[3] = { 0, 0, 0 }, maxIndex[3] = { 0, 0, 0 };
+    for (std::size_t i = 0; i < vertices.size(); i++) {
+        for (int axis = 0; axis < 3; axis++) {
+            if (vertices[i].Position[axis] < vertices[minIndex[axis]].Position[axis]) minIndex[axis] = i;
+            if (vertices[i].Position[axis] > vertices[maxIndex[axis]].Position[axis]) maxIndex[axis] = i;
+        }
+    }
+    int widest = 0;
+    float widestLength = -1.0f;
+    for (int axis = 0; axis < 3; axis++) {
+        float length = glm::length(vertices[maxIndex[axis]].Position - vertices[minIndex[axis]].Position);
+        if (length > widestLength) {
+            widestLength = length;
+            widest = axis;
+        }
+    }
+
+    glm::vec3 center = (vertices[minIndex[widest]].Position + vertices[maxIndex[widest]].Position) * 0.5f;
+    float radius = widestLength * 0.5f;
+    for (const Vertex& v : vertices) {
+        float distance = glm::length(v.Position - center);
+        if (distance > radius) {
+            float grown = (radius + distance) * 0.5f;
+            center += (v.Position - center) * ((grown - radius) / distance);
+            radius = grown;
+        }
     }
+    return BoundingSphere{ center, radius };
 }
 
-Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene) {
-    std::vector<Vertex> vertices;
-    std::vector<unsigned int> indices;
-    std::vector<Texture> textures;
+static MeshData processMesh(aiMesh* mesh, const aiScene* scene) {
+    MeshData data;
+    std::vector<Vertex>& vertices = data.vertices;
+    std::vector<unsigned int>& indices = data.indices;
+
+    // attributes the importer actually provides
+    unsigned int available = VERTEX_POSITION;
+    if (mesh->HasNormals()) available |= VERTEX_NORMAL;
+    if (mesh->mTextureCoords[0]) available |= VERTEX_TEXCOORDS;
+    if (mesh->HasTangentsAndBitangents()) available |= VERTEX_TANGENT | VERTEX_BITANGENT;
+    if (mesh->HasBones()) available |= VERTEX_BONES;
+    data.available = available;
 
     for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
-        Vertex vertex;
+        Vertex vertex{};
         glm::vec3 vector;
 
         // position
@@ -65,9 +213,39 @@ Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene) {
             vertex.TexCoords = glm::vec2(0.0f, 0.0f);
         }
 
+        // tangent space
+        if (mesh->HasTangentsAndBitangents()) {
+            vertex.Tangent = glm::vec3(mesh->mTangents[i].x, mesh->mTangents[i].y, mesh->mTangents[i].z);
+            vertex.Bitangent = glm::vec3(mesh->mBitangents[i].x, mesh->mBitangents[i].y, mesh->mBitangents[i].z);
+        }
+
+        // bounds
+        if (i == 0)
+            data.boundsMin = data.boundsMax = vertex.Position;
+        data.boundsMin = glm::min(data.boundsMin, vertex.Position);
+        data.boundsMax = glm::max(data.boundsMax, vertex.Position);
+
         vertices.push_back(vertex);
     }
 
+    // bones: the first MAX_BONE_INFLUENCE weights of each vertex, IDs indexing mesh->mBones
+    for (unsigned int b = 0; b < mesh->mNumBones; b++) {
+        const aiBone* bone = mesh->mBones[b];
+        for (unsigned int w = 0; w < bone->mNumWeights; w++) {
+            const aiVertexWeight& weight = bone->mWeights[w];
+            if (weight.mVertexId >= vertices.size() || weight.mWeight == 0.0f)
+                continue;
+            Vertex& vertex = vertices[weight.mVertexId];
+            for (int slot = 0; slot < MAX_BONE_INFLUENCE; slot++) {
+                if (vertex.m_Weights[slot] == 0.0f) {
+                    vertex.m_BoneIDs[slot] = (int)b;
+                    vertex.m_Weights[slot] = weight.mWeight;
+                    break;
+                }
+            }
+        }
+    }
+
     // indices
     for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
         aiFace face = mesh->mFaces[i];
@@ -78,70 +256,483 @@ Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene) {
     // material
     if (mesh->mMaterialIndex >= 0) {
         aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+        loadMaterialTextures(material, aiTextureType_DIFFUSE, TextureType::Diffuse, data.textures);
+        loadMaterialTextures(material, aiTextureType_SPECULAR, TextureType::Specular, data.textures);
+    }
+
+    data.sphere = computeBoundingSphere(vertices);
+    data.vertexCount = vertices.size();
+    data.indexCount = indices.size();
+    return data;
+}
+
+// meshes below this are cheap already and would only lose their shape
+static const std::size_t MIN_LOD_TRIANGLES = 64;
+
+// Appends MESH_LOD_RATIOS levels to m.indices, each simplified from the previous one.
+// The levels' errors add up, so every level reports a bound on its distance to the full mesh.
+static void generateLods(MeshData& m, bool optimize) {
+    const std::size_t triangles = m.indexCount / 3;
+    if (triangles < MIN_LOD_TRIANGLES)
+        return;
+
+    std::vector<unsigned int> previous(m.indices.begin(), m.indices.begin() + m.indexCount), simplified;
+    float error = 0.0f;
+    for (unsigned int k = 0; k < MAX_MESH_LODS; k++) {
+        std::size_t target = std::max<std::size_t>((std::size_t)(triangles * MESH_LOD_RATIOS[k]), 1) * 3;
+        error += simplifyMesh(m.vertices.data(), m.vertices.size(), previous.data(), previous.size(), target, simplified);
+        if (simplified.size() >= previous.size())
+            break;  // nothing left to collapse
+        if (optimize)
+            optimizeVertexCache(simplified, m.vertices.size());
+        m.lods.push_back(MeshLod{ m.indices.size(), simplified.size(), error });
+        m.indices.insert(m.indices.end(), simplified.begin(), simplified.end());
+        previous.swap(simplified);
+    }
+}
+
+// Splits the explodable copy into rigid chunks (see fractureTriangles), stores every face's chunk in its
+// fragment attribute and bakes the chunks' fall from the bottom center of the model. A non-empty
+// cachePath keeps the clustering on disk, keyed by the source and the mesh processing.
+static void buildDestruction(ModelData& data, const std::string& cachePath, std::uint64_t sourceHash, std::uint32_t processFlags) {
+    std::vector<glm::vec3> corners;
+    for (const MeshData& m : data.meshes) {
+        for (const ExplodeVertex& v : m.explodeVertices)
+            corners.push_back(v.position);
+    }
+    const std::size_t triangleCount = corners.size() / 3;
+    if (triangleCount == 0)
+        return;
 
-        std::vector<Texture> diffuseMaps = loadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse");
-        textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
+    Fracture fracture;
+    if (!cachePath.empty() && loadFractureCache(cachePath, sourceHash, processFlags, triangleCount, fracture)) {
+        std::cout << "FRACTURE::" << cachePath << " loaded, " << fracture.chunks.size() << " chunks (clustering took "
+            << fracture.fractureMillis << " ms)" << std::endl;
+    }
+    else {
+        fracture = fractureTriangles(corners.data(), triangleCount);
+        std::cout << "FRACTURE::" << (data.path.empty() ? "placeholder" : data.path) << ": " << triangleCount << " triangles -> "
+            << fracture.chunks.size() << " chunks in " << fracture.fractureMillis << " ms";
+        if (!cachePath.empty() && writeFractureCache(cachePath, sourceHash, processFlags, fracture))
+            std::cout << ", wrote " << cachePath;
+        std::cout << std::endl;
+    }
 
-        std::vector<Texture> specularMaps = loadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular");
-        textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
+    std::size_t triangle = 0;
+    for (MeshData& m : data.meshes) {
+        for (std::size_t i = 0; i + 2 < m.explodeVertices.size(); i += 3) {
+            float chunk = (float)fracture.chunkOfTriangle[triangle++];
+            for (int k = 0; k < 3; k++)
+                m.explodeVertices[i + k].fragment = chunk;
+        }
     }
 
-    return Mesh(vertices, indices, textures);
+    glm::vec3 lo = data.meshes[0].boundsMin, hi = data.meshes[0].boundsMax;
+    for (const MeshData& m : data.meshes) {
+        lo = glm::min(lo, m.boundsMin);
+        hi = glm::max(hi, m.boundsMax);
+    }
+    glm::vec3 origin((lo.x + hi.x) * 0.5f, lo.y, (lo.z + hi.z) * 0.5f);
+    data.destruction = bakeDestruction(fracture.chunks, origin, lo.y);
 }
 
-std::vector<Texture> Model::loadMaterialTextures(aiMaterial* mat, aiTextureType type, std::string typeName) {
-    std::vector<Texture> textures;
-    for (unsigned int i = 0; i < mat->GetTextureCount(type); i++) {
-        aiString str;
-        mat->GetTexture(type, i, &str);
-        bool skip = false;
-        for (unsigned int j = 0; j < textures_loaded.size(); j++) {
-            if (std::strcmp(textures_loaded[j].path.data(), str.C_Str()) == 0) {
-                textures.push_back(textures_loaded[j]);
-                skip = true;
-                break;
-            }
+static void buildExplodeMeshes(ModelData& data, const std::string& fractureCachePath = std::string(),
+                               std::uint64_t sourceHash = 0, std::uint32_t processFlags = 0) {
+    for (MeshData& m : data.meshes) {
+        m.explodeVertices.clear();
+        buildExplodeVertices(m.vertexData(), m.indexData(), m.indexCount, m.explodeVertices);
+    }
+    buildDestruction(data, fractureCachePath, sourceHash, processFlags);
+}
+
+static void processNode(aiNode* node, const aiScene* scene, std::vector<MeshData>& meshes) {
+    for (unsigned int i = 0; i < node->mNumMeshes; i++) {
+        aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
+        meshes.push_back(processMesh(mesh, scene));
+    }
+
+    for (unsigned int i = 0; i < node->mNumChildren; i++) {
+        processNode(node->mChildren[i], scene, meshes);
+    }
+}
+
+ModelData Model::import(const std::string& path, const ModelLoadOptions& options) {
+    auto start = std::chrono::steady_clock::now();
+    auto elapsedMs = [&start]() {
+        return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+    ModelData data;
+    data.path = path;
+    data.directory = path.substr(0, path.find_last_of('/'));
+
+    std::uint64_t sourceHash = options.useCache ? hashModelSources(path) : 0;
+    std::uint32_t processFlags = (options.optimize ? (std::uint32_t)MESH_PROCESS_OPTIMIZE : 0u)
+        | (options.generateLods ? (std::uint32_t)MESH_PROCESS_LODS : 0u);
+    std::string cachePath = processedCachePath(path, processFlags, ".meshbin");
+    std::string fractureCachePath = options.useCache ? processedCachePath(path, processFlags, ".fracture") : std::string();
+    float cachedImportMs = 0.0f;
+    if (options.useCache && loadMeshCache(cachePath, sourceHash, processFlags, data, cachedImportMs)) {
+        if (options.explodable)
+            buildExplodeMeshes(data, fractureCachePath, sourceHash, processFlags);
+        data.importMillis = elapsedMs();
+        data.valid = true;
+        std::cout << "MESH_CACHE::" << cachePath << " loaded in " << data.importMillis << " ms (Assimp import took "
+            << cachedImportMs << " ms, saved " << cachedImportMs - data.importMillis << " ms)" << std::endl;
+        return data;
+    }
+
+    Assimp::Importer importer;
+    const aiScene* scene = importer.ReadFile(path, MODEL_IMPORT_FLAGS);
+
+    if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+        std::cout << "ERROR::ASSIMP::" << importer.GetErrorString() << std::endl;
+        return data;
+    }
+
+    processNode(scene->mRootNode, scene, data.meshes);
+    if (options.optimize) {
+        for (std::size_t i = 0; i < data.meshes.size(); i++) {
+            MeshData& m = data.meshes[i];
+            MeshOptimizationReport report = optimizeMesh(m.vertices, m.indices);
+            m.vertexCount = m.vertices.size();
+            std::cout << "MESH_OPTIMIZER::" << path << " mesh " << i << ": " << report.verticesBefore << " -> "
+                << report.verticesAfter << " vertices, ACMR " << report.before.acmr << " -> " << report.after.acmr
+                << ", ATVR " << report.before.atvr << " -> " << report.after.atvr << std::endl;
         }
-        if (!skip) {
-            Texture texture;
-            texture.id = TextureFromFile(str.C_Str(), directory);
-            texture.type = typeName;
-            texture.path = str.C_Str();
-            textures.push_back(texture);
-            textures_loaded.push_back(texture);
+    }
+    if (options.generateLods) {
+        for (std::size_t i = 0; i < data.meshes.size(); i++) {
+            MeshData& m = data.meshes[i];
+            generateLods(m, options.optimize);
+            if (m.lods.empty())
+                continue;
+            std::cout << "MESH_LOD::" << path << " mesh " << i << ": " << m.indexCount / 3;
+            for (const MeshLod& lod : m.lods)
+                std::cout << " -> " << lod.indexCount / 3;
+            std::cout << " triangles, error " << m.lods.back().error << std::endl;
         }
     }
-    return textures;
+    if (options.explodable)
+        buildExplodeMeshes(data, fractureCachePath, sourceHash, processFlags);
+    data.importMillis = elapsedMs();
+    data.valid = true;
+
+    if (options.useCache && writeMeshCache(cachePath, sourceHash, MODEL_IMPORT_FLAGS, processFlags, data.importMillis, data.meshes))
+        std::cout << "MESH_CACHE::" << path << " imported in " << data.importMillis << " ms, wrote " << cachePath << std::endl;
+    return data;
 }
 
-unsigned int TextureFromFile(const char* path, const std::string& directory, bool gamma) {
-    std::string filename = std::string(path);
-    filename = directory + '/' + filename;
+Model::Model(ModelData data, const ModelLoadOptions& options)
+    : directory(data.directory), options(options) {
+    ranges.reserve(data.meshes.size());
+    for (const MeshData& m : data.meshes) {
+        std::vector<Texture> textures;
+        for (const TextureRef& ref : m.textures)
+            textures.push_back(loadTexture(ref.path.c_str(), ref.type));
 
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
+        DrawRange range = {};
+        range.indexCount = (GLsizei)m.indexCount;
+        range.vertexCount = (GLsizei)m.vertexCount;
+        range.material = findMaterial(std::move(textures));
+        range.boundsMin = m.boundsMin;
+        range.boundsMax = m.boundsMax;
+        range.sphere = m.sphere;
+        range.lodCount = (unsigned int)std::min<std::size_t>(m.lods.size(), MAX_MESH_LODS);
+        for (unsigned int k = 0; k < range.lodCount; k++) {
+            range.lods[k].indexCount = (GLsizei)m.lods[k].indexCount;
+            if (k + 1 >= lodErrors.size())
+                lodErrors.push_back(0.0f);
+            lodErrors[k + 1] = std::max(lodErrors[k + 1], m.lods[k].error);
+        }
+        ranges.push_back(range);
+    }
+    // a range with fewer levels draws its coarsest one, so the error of the missing levels carries over
+    for (std::size_t i = 0; i < ranges.size(); i++) {
+        const MeshData& m = data.meshes[i];
+        for (std::size_t k = m.lods.size(); k + 1 < lodErrors.size(); k++)
+            lodErrors[k + 1] = std::max(lodErrors[k + 1], m.lods.empty() ? 0.0f : m.lods.back().error);
+    }
+    upload(data.meshes);
+    if (!data.destruction.empty()) {
+        destructionTexture = GLTexture(DestructionTextureFromBake(data.destruction));
+        destructionFps = data.destruction.fps;
+        // the bake is centered on the bottom of the bounds, the reach is wanted from the bounding center
+        glm::vec3 origin((bounds[0].x + bounds[1].x) * 0.5f, bounds[0].y, (bounds[0].z + bounds[1].z) * 0.5f);
+        destructionReach_ = data.destruction.reach + glm::length(origin - sphere.center);
+        data.destruction.texels.clear();
+    }
+
+    if (!data.path.empty())
+        reportVertexFormat(data.path);
+    if (options.keepCpuData)
+        cpuData = std::move(data);
+}
+
+// sub-meshes with the same textures share a material, so Draw binds it once for consecutive ranges
+unsigned int Model::findMaterial(std::vector<Texture> textures) {
+    auto same = [&textures](const Material& material) {
+        return std::equal(material.textures.begin(), material.textures.end(), textures.begin(), textures.end(),
+            [](const Texture& a, const Texture& b) { return a.id == b.id && a.type == b.type; });
+    };
+    auto found = std::find_if(materials.begin(), materials.end(), same);
+    if (found != materials.end())
+        return (unsigned int)(found - materials.begin());
+    std::vector<TextureBinding> bindings = makeTextureBindings(textures);
+    std::uint32_t key = materialHash(bindings);
+    materials.push_back(Material{ std::move(textures), std::move(bindings), key });
+    return (unsigned int)materials.size() - 1;
+}
+
+// packs every mesh into one vertex and one index buffer; ranges[i] must already describe meshes[i]
+void Model::upload(const std::vector<MeshData>& meshes) {
+    // one layout for all ranges: the attributes any mesh provides (zero where a mesh lacks them),
+    // positions quantized against the model's bounds
+    unsigned int available = 0;
+    glm::vec3 boundsMin(0.0f), boundsMax(0.0f);
+    std::size_t vertexTotal = 0, indexTotal = 0, largestMesh = 0;
+    for (std::size_t i = 0; i < meshes.size(); i++) {
+        const MeshData& m = meshes[i];
+        available |= m.available;
+        boundsMin = i ? glm::min(boundsMin, m.boundsMin) : m.boundsMin;
+        boundsMax = i ? glm::max(boundsMax, m.boundsMax) : m.boundsMax;
+        ranges[i].baseVertex = (GLint)vertexTotal;
+        ranges[i].firstIndex = (GLuint)indexTotal;
+        for (unsigned int k = 0; k < ranges[i].lodCount; k++)
+            ranges[i].lods[k].firstIndex = (GLuint)(indexTotal + m.lods[k].firstIndex);
+        vertexTotal += m.vertexCount;
+        indexTotal += m.totalIndexCount();
+        largestMesh = std::max(largestMesh, m.vertexCount);
+    }
+    bounds[0] = boundsMin;
+    bounds[1] = boundsMax;
+    // whichever is smaller of the box's circumsphere and a sphere around all range spheres
+    sphere = BoundingSphere{ (boundsMin + boundsMax) * 0.5f, glm::length(boundsMax - boundsMin) * 0.5f };
+    float enclosing = 0.0f;
+    for (const DrawRange& range : ranges)
+        enclosing = std::max(enclosing, glm::length(range.sphere.center - sphere.center) + range.sphere.radius);
+    sphere.radius = std::min(sphere.radius, enclosing);
+    layout = makeVertexLayout(options.format, available, boundsMin, boundsMax);
+    // indices are relative to baseVertex, so 16 bits suffice as long as every single mesh fits
+    indexType = largestMesh < 65536 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    const GLsizeiptr indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int);
 
-    int width, height, nrComponents;
-    stbi_set_flip_vertically_on_load(true);
-    unsigned char* data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
-    if (data) {
-        GLenum format = nrComponents == 3 ? GL_RGB : GL_RGBA;
+    VAO = makeVertexArray();
+    VBO = makeBuffer();
+    EBO = makeBuffer();
+    glState().bindVertexArray(VAO);
+    glState().bindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexTotal * layout.stride, nullptr, GL_STATIC_DRAW);
+    glState().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexTotal * indexSize, nullptr, GL_STATIC_DRAW);
+
+    std::vector<unsigned char> packed;
+    std::vector<unsigned short> shortIndices;
+    for (std::size_t i = 0; i < meshes.size(); i++) {
+        const MeshData& m = meshes[i];
+        const DrawRange& range = ranges[i];
+        GLintptr vertexOffset = (GLintptr)range.baseVertex * layout.stride;
+        if (layout.isFullVertex()) {
+            glBufferSubData(GL_ARRAY_BUFFER, vertexOffset, m.vertexCount * sizeof(Vertex), m.vertexData());
+        }
+        else {
+            packVertices(layout, m.vertexData(), m.vertexCount, packed);
+            glBufferSubData(GL_ARRAY_BUFFER, vertexOffset, packed.size(), packed.data());
+        }
 
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
+        GLintptr indexOffset = (GLintptr)range.firstIndex * indexSize;
+        const std::size_t indexCount = m.totalIndexCount();
+        if (indexType == GL_UNSIGNED_SHORT) {
+            shortIndices.assign(m.indexData(), m.indexData() + indexCount);
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indexOffset, indexCount * indexSize, shortIndices.data());
+        }
+        else {
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indexOffset, indexCount * indexSize, m.indexData());
+        }
+    }
 
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    setVertexAttributes(layout);
 
-        stbi_image_free(data);
+    // explodable variant: separate de-indexed buffer, float attributes
+    explodeVertexCount = 0;
+    for (std::size_t i = 0; i < meshes.size(); i++) {
+        ranges[i].explodeFirst = (GLint)explodeVertexCount;
+        ranges[i].explodeCount = (GLsizei)meshes[i].explodeVertices.size();
+        explodeVertexCount += meshes[i].explodeVertices.size();
     }
-    else {
-        std::cout << "Texture failed to load at path: " << filename << std::endl;
-        stbi_image_free(data);
+    if (explodeVertexCount) {
+        explodeVAO = makeVertexArray();
+        explodeVBO = makeBuffer();
+        glState().bindVertexArray(explodeVAO);
+        glState().bindBuffer(GL_ARRAY_BUFFER, explodeVBO);
+        glBufferData(GL_ARRAY_BUFFER, explodeVertexCount * sizeof(ExplodeVertex), nullptr, GL_STATIC_DRAW);
+        for (std::size_t i = 0; i < meshes.size(); i++) {
+            const std::vector<ExplodeVertex>& v = meshes[i].explodeVertices;
+            if (!v.empty())
+                glBufferSubData(GL_ARRAY_BUFFER, ranges[i].explodeFirst * sizeof(ExplodeVertex), v.size() * sizeof(ExplodeVertex), v.data());
+        }
+        setExplodeVertexAttributes();
     }
+    glState().bindVertexArray(0);
+}
 
+Model Model::placeholder(const ModelLoadOptions& options) {
+    MeshData box;
+    box.available = VERTEX_POSITION | VERTEX_NORMAL | VERTEX_TEXCOORDS;
+    box.boundsMin = glm::vec3(-0.5f);
+    box.boundsMax = glm::vec3(0.5f);
+    for (int axis = 0; axis < 3; axis++) {
+        for (int side = 0; side < 2; side++) {
+            glm::vec3 normal(0.0f);
+            normal[axis] = side ? 1.0f : -1.0f;
+            glm::vec3 u(0.0f), v(0.0f);
+            u[(axis + 1) % 3] = 0.5f;
+            v[(axis + 2) % 3] = side ? 0.5f : -0.5f;  // keeps every face wound counter-clockwise seen from outside
+            unsigned int first = (unsigned int)box.vertices.size();
+            const glm::vec2 corners[4] = { {-1, -1}, {1, -1}, {1, 1}, {-1, 1} };
+            for (const glm::vec2& c : corners) {
+                Vertex vertex{};
+                vertex.Position = normal * 0.5f + u * c.x + v * c.y;
+                vertex.Normal = normal;
+                vertex.TexCoords = c * 0.5f + 0.5f;
+                box.vertices.push_back(vertex);
+            }
+            for (unsigned int k : { 0u, 1u, 2u, 0u, 2u, 3u })
+                box.indices.push_back(first + k);
+        }
+    }
+    box.sphere = computeBoundingSphere(box.vertices);
+    box.vertexCount = box.vertices.size();
+    box.indexCount = box.indices.size();
+
+    ModelData data;
+    data.meshes.push_back(std::move(box));
+    data.valid = true;
+    if (options.explodable)
+        buildExplodeMeshes(data);
+    return Model(std::move(data), options);
+}
+
+std::size_t Model::triangleCount(unsigned int lod) const {
+    std::size_t triangles = 0;
+    for (const DrawRange& range : ranges)
+        triangles += range.level(lod).indexCount / 3;
+    return triangles;
+}
+
+unsigned int LodSelector::select(const Model& model, float radiusPixels, float maxErrorPixels) {
+    float radius = model.boundingRadius();
+    if (radius <= 0.0f)
+        return level = 0;
+    // object-space error -> pixels, at the same scale as the bounding sphere
+    const float pixelsPerUnit = radiusPixels / radius;
+    auto fits = [&](unsigned int lod, float limit) { return model.lodError(lod) * pixelsPerUnit <= limit; };
+
+    unsigned int coarsest = 0;
+    while (coarsest + 1 < model.lodLevels() && fits(coarsest + 1, maxErrorPixels))
+        coarsest++;
+    if (coarsest < level)
+        level = coarsest;  // refine at once, popping detail in is less visible than holding too little
+    else if (coarsest > level) {
+        // coarsen only as far as stays clear of the threshold
+        while (level < coarsest && fits(level + 1, maxErrorPixels * (1.0f - LOD_HYSTERESIS)))
+            level++;
+    }
+    return level;
+}
+
+float projectedRadius(const glm::vec3& center, float radius, const glm::vec3& cameraPos, float fovY, float viewportHeight) {
+    float distance = glm::length(center - cameraPos);
+    if (distance <= radius)
+        return viewportHeight;  // camera inside the sphere
+    return radius / (distance * std::tan(fovY * 0.5f)) * viewportHeight * 0.5f;
+}
+
+// vertex bytes uploaded against the full 88 byte Vertex
+void Model::reportVertexFormat(const std::string& path) const {
+    size_t vertexCount = 0;
+    for (const DrawRange& range : ranges)
+        vertexCount += range.vertexCount;
+    size_t full = vertexCount * sizeof(Vertex);
+    size_t packed = vertexCount * layout.stride;
+    for (size_t i = 0; i < ranges.size(); i++) {
+        size_t rangeFull = (size_t)ranges[i].vertexCount * sizeof(Vertex);
+        size_t rangePacked = (size_t)ranges[i].vertexCount * layout.stride;
+        std::cout << "VERTEX_FORMAT::" << path << " mesh " << i << ": " << ranges[i].vertexCount << " vertices, "
+            << sizeof(Vertex) << " -> " << layout.stride << " bytes/vertex, saved " << (rangeFull - rangePacked) / 1024 << " KB"
+            << std::endl;
+    }
+    std::cout << "VERTEX_FORMAT::" << path << ": " << ranges.size() << " meshes in one buffer, " << vertexCount << " vertices, "
+        << sizeof(Vertex) << " -> " << layout.stride << " bytes/vertex, " << full / 1024 << " KB -> " << packed / 1024 << " KB, "
+        << (indexType == GL_UNSIGNED_SHORT ? 16 : 32) << "-bit indices";
+    if (explodable())
+        std::cout << ", explodable copy " << explodeVertexCount << " vertices (" << explodeVertexCount * sizeof(ExplodeVertex) / 1024 << " KB)";
+    if (hasDestruction())
+        std::cout << ", baked destruction reaching " << destructionReach_;
+    std::cout << std::endl;
+}
+
+Texture Model::loadTexture(const char* path, TextureType type) {
+    // the same file may serve as more than one type
+    auto found = textures_loaded.find(path);
+    if (found != textures_loaded.end())
+        return Texture{ found->second.id, type };
+
+    std::shared_ptr<GLTexture> object = options.assets
+        ? options.assets->loadTexture(path, directory)
+        : std::make_shared<GLTexture>(TextureFromFile(path, directory));
+    Texture texture;
+    texture.id = object->get();
+    texture.type = type;
+    textureObjects.push_back(std::move(object));
+    textures_loaded.emplace(path, texture);
+    return texture;
+}
+
+DecodedImage::~DecodedImage() {
+    if (pixels)
+        stbi_image_free(pixels);
+}
+
+DecodedImage decodeImage(const std::string& file) {
+    // stb_image keeps the flip flag in a global; set it exactly once, before any decode reads it
+    static const bool flipped = (stbi_set_flip_vertically_on_load(true), true);
+    (void)flipped;
+
+    DecodedImage image;
+    image.pixels = stbi_load(file.c_str(), &image.width, &image.height, &image.channels, 0);
+    return image;
+}
+
+unsigned int TextureFromImage(const DecodedImage& image, const void* pixels) {
+    GLenum format = image.channels == 1 ? GL_RED
+        : image.channels == 3 ? GL_RGB
+        : GL_RGBA;
+
+    unsigned int textureID;
+    glGenTextures(1, &textureID);
+    glState().bindTexture(0, textureID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);  // RGB rows are not 4-byte aligned in general
+    glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, pixels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     return textureID;
-}
\ No newline at end of file
+}
+
+unsigned int TextureFromFile(const char* path, const std::string& directory, bool gamma) {
+    std::string filename = std::string(path);
+    filename = directory + '/' + filename;
+
+    DecodedImage image = decodeImage(filename);
+    if (image)
+        return TextureFromImage(image, image.pixels);
+
+    std::cout << "Texture failed to load at path: " << filename << std::endl;
+    unsigned int textureID;
+    glGenTextures(1, &textureID);
+    return textureID;
+}
@@ -0,0 +1,327 @@
+#include <learnopengl/particle_sort.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+static const std::size_t DIGIT_VALUES = 1u << PARTICLE_SORT_DIGIT_BITS;
+static const unsigned int MAX_SORT_THREADS = 8;
+
+static std::uint32_t keyOf(std::uint64_t item) {
+    return (std::uint32_t)(item >> 32);
+}
+
+// particle i's view depth along forward, quantized to PARTICLE_DEPTH_BITS and inverted, so the ascending
+// sort puts the farthest particle first; scale maps farDepth to the largest key
+static std::uint32_t depthKey(const ParticlePool& pool, std::size_t i, const glm::vec3& cameraPos, const glm::vec3& forward,
+                              float scale) {
+    const float keyMax = (float)((1u << PARTICLE_DEPTH_BITS) - 1);
+    float depth = (pool.x[i] - cameraPos.x) * forward.x + (pool.y[i] - cameraPos.y) * forward.y
+        + (pool.z[i] - cameraPos.z) * forward.z;
+    return (1u << PARTICLE_DEPTH_BITS) - 1 - (std::uint32_t)std::min(std::max(depth * scale, 0.0f), keyMax);
+}
+
+static float depthKeyScale(float farDepth) {
+    return farDepth > 0.0f ? (float)((1u << PARTICLE_DEPTH_BITS) - 1) / farDepth : 0.0f;
+}
+
+namespace {
+// every thread waits until all have arrived; reusable
+class Barrier {
+public:
+    explicit Barrier(unsigned int count) : count(count) {}
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        std::size_t arrivedIn = generation;
+        if (++waiting == count) {
+            waiting = 0;
+            generation++;
+            wake.notify_all();
+            return;
+        }
+        wake.wait(lock, [&] { return generation != arrivedIn; });
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable wake;
+    unsigned int count, waiting = 0;
+    std::size_t generation = 0;
+};
+}
+
+SortThreads::SortThreads(unsigned int count) {
+    for (unsigned int t = 1; t < count; t++)
+        workers.emplace_back(&SortThreads::workerLoop, this, t);
+}
+
+SortThreads::~SortThreads() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers)
+        worker.join();
+}
+
+void SortThreads::run(const std::function<void(unsigned int)>& work) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &work;
+        busy = (unsigned int)workers.size();
+        generation++;
+    }
+    wake.notify_all();
+    work(0);
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this]() { return busy == 0; });
+    job = nullptr;
+}
+
+void SortThreads::workerLoop(unsigned int t) {
+    std::size_t seen = 0;
+    for (;;) {
+        const std::function<void(unsigned int)>* work;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this, seen]() { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+            work = job;
+        }
+
+        (*work)(t);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busy == 0)
+            done.notify_one();
+    }
+}
+
+void radixSortDepthKeys(std::vector<std::uint64_t>& items, std::vector<std::uint64_t>& scratch, SortThreads* sortThreads) {
+    const std::size_t n = items.size();
+    if (n < 2)
+        return;
+    scratch.resize(n);
+    const unsigned int threads = sortThreads && n >= PARTICLE_SORT_PARALLEL_MIN ? sortThreads->count() : 1;
+    const unsigned int passes = (PARTICLE_DEPTH_BITS + PARTICLE_SORT_DIGIT_BITS - 1) / PARTICLE_SORT_DIGIT_BITS;
+
+    // offsets[t][digit]: histogram of thread t's slice, then where that slice writes the digit
+    std::vector<std::vector<std::size_t>> offsets(threads, std::vector<std::size_t>(DIGIT_VALUES));
+    std::uint64_t* buffers[2] = { items.data(), scratch.data() };
+    int source = 0;  // same in every thread, only changed between barriers
+    bool skip = false;
+    Barrier barrier(threads);
+
+    auto run = [&](unsigned int t) {
+        const std::size_t begin = n * t / threads, end = n * (t + 1) / threads;
+        std::vector<std::size_t>& offset = offsets[t];
+        for (unsigned int pass = 0; pass < passes; pass++) {
+            const unsigned int shift = 32 + pass * PARTICLE_SORT_DIGIT_BITS;
+            const std::uint64_t* src = buffers[source];
+            std::fill(offset.begin(), offset.end(), 0);
+            for (std::size_t i = begin; i < end; i++)
+                offset[src[i] >> shift & (DIGIT_VALUES - 1)]++;
+            barrier.wait();
+
+            if (t == 0) {
+                // digit-major, thread-minor prefix sum keeps equal keys in slice order: stable
+                std::size_t sum = 0;
+                skip = false;
+                for (std::size_t d = 0; d < DIGIT_VALUES; d++) {
+                    std::size_t digitTotal = 0;
+                    for (unsigned int k = 0; k < threads; k++) {
+                        std::size_t c = offsets[k][d];
+                        offsets[k][d] = sum;
+                        sum += c;
+                        digitTotal += c;
+                    }
+                    skip |= digitTotal == n;  // every key has this digit
+                }
+            }
+            barrier.wait();
+
+            if (!skip) {
+                std::uint64_t* dst = buffers[1 - source];
+                for (std::size_t i = begin; i < end; i++)
+                    dst[offset[src[i] >> shift & (DIGIT_VALUES - 1)]++] = src[i];
+            }
+            barrier.wait();
+            if (t == 0 && !skip)
+                source = 1 - source;
+            barrier.wait();
+        }
+    };
+
+    if (threads > 1)
+        sortThreads->run(run);
+    else
+        run(0);
+    if (source == 1)
+        items.swap(scratch);
+}
+
+ParticleDepthSorter::ParticleDepthSorter(unsigned int threads) : threadCount(threads) {
+    if (threadCount == 0)
+        threadCount = std::min(std::max(std::thread::hardware_concurrency(), 1u), MAX_SORT_THREADS);
+}
+
+// insertion sort of items, which the previous frame's order left nearly sorted; false once it moved
+// more than budget elements, with items still a permutation of the input
+bool ParticleDepthSorter::repair(std::size_t budget) {
+    std::size_t moves = 0;
+    for (std::size_t i = 1; i < items.size(); i++) {
+        std::uint64_t item = items[i];
+        std::size_t j = i;
+        while (j > 0 && keyOf(items[j - 1]) > keyOf(item)) {
+            items[j] = items[j - 1];
+            j--;
+            moves++;
+        }
+        items[j] = item;
+        if (moves > budget)
+            return false;
+    }
+    return true;
+}
+
+const std::vector<std::uint32_t>& ParticleDepthSorter::sort(const ParticlePool& pool, const glm::vec3& cameraPos,
+                                                            const glm::vec3& forward, float farDepth) {
+    auto start = std::chrono::steady_clock::now();
+    const std::size_t n = pool.count;
+    const float scale = depthKeyScale(farDepth);
+    // keyed in pool order, so the positions are read sequentially
+    keys.resize(n);
+    for (std::size_t i = 0; i < n; i++)
+        keys[i] = depthKey(pool, i, cameraPos, forward, scale);
+    auto item = [this](std::uint32_t i) { return (std::uint64_t)keys[i] << 32 | i; };
+
+    bool repaired = false, listed = false;
+    items.clear();
+    if (valid && glm::length(cameraPos - sortedFrom) < PARTICLE_RESORT_DISTANCE && glm::dot(forward, sortedAlong) > PARTICLE_RESORT_COS) {
+        // The previous order covers [0, sortedCount); killed particles were swap-removed, so keeping the
+        // indices below count and appending the new ones covers [0, count) exactly.
+        for (std::uint32_t i : order) {
+            if (i < n)
+                items.push_back(item(i));
+        }
+        for (std::size_t i = sortedCount; i < n; i++)
+            items.push_back(item((std::uint32_t)i));
+        repaired = repair(n * PARTICLE_RESORT_MOVES);
+        listed = true;  // a failed repair leaves a permutation, and the radix sort takes any order
+    }
+    if (!repaired) {
+        if (!listed) {
+            for (std::size_t i = 0; i < n; i++)
+                items.push_back(item((std::uint32_t)i));
+        }
+        if (threadCount > 1 && n >= PARTICLE_SORT_PARALLEL_MIN && !workers)
+            workers = std::make_unique<SortThreads>(threadCount);
+        radixSortDepthKeys(items, scratch, workers.get());
+        valid = true;
+        sortedFrom = cameraPos;
+        sortedAlong = forward;
+    }
+
+    order.resize(n);
+    for (std::size_t i = 0; i < n; i++)
+        order[i] = (std::uint32_t)items[i];
+    sortedCount = n;
+
+    double millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (repaired) {
+        stats_.repairs++;
+        stats_.repairMillis += millis;
+    }
+    else {
+        stats_.fullSorts++;
+        stats_.fullMillis += millis;
+    }
+    return order;
+}
+
+void benchmarkParticleSort() {
+    const std::size_t sizes[] = { 10000, 100000, 1000000 };
+    const int REPEATS = 5;
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> spread(-50.0f, 50.0f);
+    const glm::vec3 camera(0.0f, 2.0f, 60.0f), forward(0.0f, 0.0f, -1.0f);
+    const float farDepth = 120.0f;
+
+    // best of REPEATS, in milliseconds
+    auto time = [&](auto&& setup, auto&& work) {
+        double best = 1e30;
+        for (int r = 0; r < REPEATS; r++) {
+            setup();
+            auto start = std::chrono::steady_clock::now();
+            work();
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    };
+
+    for (std::size_t n : sizes) {
+        ParticlePool pool(n);
+        ParticleRange range = pool.allocate(n, 0);
+        for (std::size_t i = range.first; i < range.first + range.count; i++)
+            pool.set(i, glm::vec3(spread(random), spread(random), spread(random)), glm::vec3(spread(random), spread(random), spread(random)) * 0.05f, 1.0f);
+
+        ParticleDepthSorter single(1), parallel;
+        double singleMs = time([&] { single.invalidate(); }, [&] { single.sort(pool, camera, forward, farDepth); });
+        double parallelMs = time([&] { parallel.invalidate(); }, [&] { parallel.sort(pool, camera, forward, farDepth); });
+
+        // the same keys in pool order, stable sorted: what both full radix sorts must produce
+        const float scale = depthKeyScale(farDepth);
+        std::vector<std::uint64_t> reference;
+        for (std::size_t i = 0; i < n; i++)
+            reference.push_back((std::uint64_t)depthKey(pool, i, camera, forward, scale) << 32 | i);
+        std::stable_sort(reference.begin(), reference.end(), [](std::uint64_t a, std::uint64_t b) { return keyOf(a) < keyOf(b); });
+        auto mismatches = [&reference](const std::vector<std::uint32_t>& order) {
+            std::size_t count = order.size() == reference.size() ? 0 : std::max(order.size(), reference.size());
+            for (std::size_t i = 0; i < std::min(order.size(), reference.size()); i++)
+                count += order[i] != (std::uint32_t)reference[i];
+            return count;
+        };
+        single.invalidate();
+        parallel.invalidate();
+        std::size_t singleWrong = mismatches(single.sort(pool, camera, forward, farDepth));
+        std::size_t parallelWrong = mismatches(parallel.sort(pool, camera, forward, farDepth));
+        // one 60 Hz frame later, the camera a small step on: the previous order is repaired, unless the
+        // particles are so dense that it runs over budget and falls back to a full sort
+        const glm::vec3 nudged = camera + glm::vec3(0.05f, 0.0f, -0.05f);
+        ParticlePool moved = pool;
+        std::size_t fullBefore = 0;
+        double repairMs = time(
+            [&] {
+                moved = pool;
+                parallel.sort(moved, camera, forward, farDepth);
+                updateParticles(moved, 1.0f / 60.0f);
+                fullBefore = parallel.stats().fullSorts;
+            },
+            [&] { parallel.sort(moved, nudged, forward, farDepth); });
+        bool fellBack = parallel.stats().fullSorts != fullBefore;
+
+        // keyed like the radix sorts, the index breaking ties so the order matches theirs
+        std::vector<std::uint64_t> keys;
+        double stdSortMs = time(
+            [&] { keys.clear(); },
+            [&] {
+                for (std::size_t i = 0; i < n; i++)
+                    keys.push_back((std::uint64_t)depthKey(pool, i, camera, forward, scale) << 32 | i);
+                std::sort(keys.begin(), keys.end());
+            });
+
+        std::cout << "Particle sort, " << n << " particles: radix " << singleMs << " ms on 1 thread, " << parallelMs << " ms on "
+            << parallel.threads() << ", next frame " << repairMs << " ms (" << (fellBack ? "full sort" : "repaired") << "), std::sort " << stdSortMs
+            << " ms, keys included in all";
+        if (singleWrong + parallelWrong)
+            std::cout << "; MISMATCH with std::stable_sort at " << singleWrong << " positions on 1 thread, " << parallelWrong << " on "
+                << parallel.threads();
+        else
+            std::cout << "; both orders match std::stable_sort";
+        std::cout << std::endl;
+    }
+}
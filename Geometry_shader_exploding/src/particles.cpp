@@ -0,0 +1,221 @@
+#include <learnopengl/particles.h>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define PARTICLES_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PARTICLES_SSE
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define PARTICLES_NEON
+#endif
+
+static const float PARTICLE_GRAVITY = -9.8f;
+
+void ParticlePool::resize(std::size_t capacity) {
+    capacity_ = capacity;
+    x.assign(capacity, 0.0f);  y.assign(capacity, 0.0f);  z.assign(capacity, 0.0f);
+    vx.assign(capacity, 0.0f); vy.assign(capacity, 0.0f); vz.assign(capacity, 0.0f);
+    life.assign(capacity, 0.0f);
+    priority.assign(capacity, 0);
+    candidates_.reserve(capacity);
+    clear();
+}
+
+ParticleRange ParticlePool::allocate(std::size_t n, std::uint8_t p) {
+    n = std::min(n, capacity_);
+    std::size_t free = capacity_ - count;
+    if (n > free)
+        stolen += steal(n - free, p);
+
+    ParticleRange range{ count, std::min(n, capacity_ - count) };
+    std::fill(priority.begin() + range.first, priority.begin() + range.first + range.count, p);
+    count += range.count;
+    return range;
+}
+
+void ParticlePool::set(std::size_t i, const glm::vec3& pos, const glm::vec3& velocity, float l) {
+    x[i] = pos.x;       y[i] = pos.y;       z[i] = pos.z;
+    vx[i] = velocity.x; vy[i] = velocity.y; vz[i] = velocity.z;
+    life[i] = l;
+}
+
+// kills the n oldest particles whose priority is at most p, returns how many were freed
+std::size_t ParticlePool::steal(std::size_t n, std::uint8_t p) {
+    candidates_.clear();
+    for (std::size_t i = 0; i < count; i++)
+        if (priority[i] <= p)
+            candidates_.push_back((std::uint32_t)i);
+
+    n = std::min(n, candidates_.size());
+    if (n == 0)
+        return 0;
+    auto byLife = [this](std::uint32_t a, std::uint32_t b) { return life[a] < life[b]; };
+    if (n < candidates_.size())
+        std::nth_element(candidates_.begin(), candidates_.begin() + n, candidates_.end(), byLife);
+    for (std::size_t k = 0; k < n; k++)
+        life[candidates_[k]] = 0.0f;
+    compact();
+    return n;
+}
+
+void ParticlePool::kill(std::size_t i) {
+    std::size_t last = --count;
+    x[i] = x[last];   y[i] = y[last];   z[i] = z[last];
+    vx[i] = vx[last]; vy[i] = vy[last]; vz[i] = vz[last];
+    life[i] = life[last];
+    priority[i] = priority[last];
+}
+
+void ParticlePool::compact() {
+    std::size_t i = 0;
+    while (i < count) {
+        if (life[i] <= 0.0f)
+            kill(i);
+        else
+            i++;
+    }
+}
+
+std::size_t ParticlePool::gatherPositions(glm::vec3* dst) const {
+    for (std::size_t i = 0; i < count; i++)
+        dst[i] = glm::vec3(x[i], y[i], z[i]);
+    return count;
+}
+
+std::size_t ParticlePool::gatherPositions(const std::uint32_t* order, std::size_t n, glm::vec3* dst) const {
+    for (std::size_t i = 0; i < n; i++)
+        dst[i] = glm::vec3(x[order[i]], y[order[i]], z[order[i]]);
+    return n;
+}
+
+// a*b + c below must round twice like the SIMD mul + add, never contract into one FMA
+#if defined(_MSC_VER) && !defined(__clang__)
+#pragma fp_contract(off)
+#elif defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+// integrates particles [begin, end) one at a time
+static void integrateScalar(ParticlePool& p, std::size_t begin, std::size_t end, float dt, float gdt) {
+    for (std::size_t i = begin; i < end; i++) {
+        p.life[i] = p.life[i] - dt;
+        p.vy[i] = p.vy[i] + gdt;
+        p.x[i] = p.x[i] + p.vx[i] * dt;
+        p.y[i] = p.y[i] + p.vy[i] * dt;
+        p.z[i] = p.z[i] + p.vz[i] * dt;
+    }
+}
+
+void updateParticlesScalar(ParticlePool& pool, float dt) {
+    integrateScalar(pool, 0, pool.count, dt, PARTICLE_GRAVITY * dt);
+    pool.compact();
+}
+
+void updateParticlesSimd(ParticlePool& pool, float dt) {
+    const float gdt = PARTICLE_GRAVITY * dt;
+    const std::size_t n = pool.count;
+    std::size_t i = 0;
+    float* px = pool.x.data();   float* py = pool.y.data();   float* pz = pool.z.data();
+    float* vx = pool.vx.data();  float* vy = pool.vy.data();  float* vz = pool.vz.data();
+    float* life = pool.life.data();
+
+    // explicit mul + add (never fused) to stay bit-identical with the scalar path
+#if defined(PARTICLES_AVX2)
+    const __m256 vdt = _mm256_set1_ps(dt);
+    const __m256 vgdt = _mm256_set1_ps(gdt);
+    for (; i + PARTICLE_LANES <= n; i += PARTICLE_LANES) {
+        _mm256_storeu_ps(life + i, _mm256_sub_ps(_mm256_loadu_ps(life + i), vdt));
+        __m256 nvy = _mm256_add_ps(_mm256_loadu_ps(vy + i), vgdt);
+        _mm256_storeu_ps(vy + i, nvy);
+        _mm256_storeu_ps(px + i, _mm256_add_ps(_mm256_loadu_ps(px + i), _mm256_mul_ps(_mm256_loadu_ps(vx + i), vdt)));
+        _mm256_storeu_ps(py + i, _mm256_add_ps(_mm256_loadu_ps(py + i), _mm256_mul_ps(nvy, vdt)));
+        _mm256_storeu_ps(pz + i, _mm256_add_ps(_mm256_loadu_ps(pz + i), _mm256_mul_ps(_mm256_loadu_ps(vz + i), vdt)));
+    }
+#elif defined(PARTICLES_SSE)
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128 vgdt = _mm_set1_ps(gdt);
+    for (; i + PARTICLE_LANES <= n; i += PARTICLE_LANES) {
+        for (std::size_t k = i; k < i + PARTICLE_LANES; k += 4) {
+            _mm_storeu_ps(life + k, _mm_sub_ps(_mm_loadu_ps(life + k), vdt));
+            __m128 nvy = _mm_add_ps(_mm_loadu_ps(vy + k), vgdt);
+            _mm_storeu_ps(vy + k, nvy);
+            _mm_storeu_ps(px + k, _mm_add_ps(_mm_loadu_ps(px + k), _mm_mul_ps(_mm_loadu_ps(vx + k), vdt)));
+            _mm_storeu_ps(py + k, _mm_add_ps(_mm_loadu_ps(py + k), _mm_mul_ps(nvy, vdt)));
+            _mm_storeu_ps(pz + k, _mm_add_ps(_mm_loadu_ps(pz + k), _mm_mul_ps(_mm_loadu_ps(vz + k), vdt)));
+        }
+    }
+#elif defined(PARTICLES_NEON)
+    const float32x4_t vdt = vdupq_n_f32(dt);
+    const float32x4_t vgdt = vdupq_n_f32(gdt);
+    for (; i + PARTICLE_LANES <= n; i += PARTICLE_LANES) {
+        for (std::size_t k = i; k < i + PARTICLE_LANES; k += 4) {
+            vst1q_f32(life + k, vsubq_f32(vld1q_f32(life + k), vdt));
+            float32x4_t nvy = vaddq_f32(vld1q_f32(vy + k), vgdt);
+            vst1q_f32(vy + k, nvy);
+            vst1q_f32(px + k, vaddq_f32(vld1q_f32(px + k), vmulq_f32(vld1q_f32(vx + k), vdt)));
+            vst1q_f32(py + k, vaddq_f32(vld1q_f32(py + k), vmulq_f32(nvy, vdt)));
+            vst1q_f32(pz + k, vaddq_f32(vld1q_f32(pz + k), vmulq_f32(vld1q_f32(vz + k), vdt)));
+        }
+    }
+#endif
+
+    // remainder (or everything, when no SIMD instruction set is available)
+    integrateScalar(pool, i, n, dt, gdt);
+    pool.compact();
+}
+
+void updateParticles(ParticlePool& pool, float dt, ParticleKernel kernel) {
+    if (kernel == ParticleKernel::Scalar)
+        updateParticlesScalar(pool, dt);
+    else
+        updateParticlesSimd(pool, dt);
+}
+
+bool verifyParticleKernels(std::size_t count, unsigned int seed, int steps) {
+    ParticlePool scalar(count), simd(count);
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    ParticleRange range = scalar.allocate(count, 0);
+    for (std::size_t i = range.first; i < range.first + range.count; i++) {
+        glm::vec3 pos(unit(random), unit(random), unit(random));
+        glm::vec3 velocity = glm::vec3(unit(random), unit(random), unit(random)) * 10.0f;
+        scalar.set(i, pos * 5.0f, velocity, 0.5f + unit(random) * 0.5f);
+    }
+    simd = scalar;
+
+    // particles die along the way, so the compaction is compared too
+    const float dt = 1.0f / 60.0f;
+    auto same = [](const std::vector<float>& a, const std::vector<float>& b, std::size_t n) {
+        return std::memcmp(a.data(), b.data(), n * sizeof(float)) == 0;
+    };
+    for (int step = 0; step < steps; step++) {
+        updateParticlesScalar(scalar, dt);
+        updateParticlesSimd(simd, dt);
+        std::size_t n = scalar.count;
+        if (simd.count != n || !same(scalar.x, simd.x, n) || !same(scalar.y, simd.y, n) || !same(scalar.z, simd.z, n)
+            || !same(scalar.vx, simd.vx, n) || !same(scalar.vy, simd.vy, n) || !same(scalar.vz, simd.vz, n)
+            || !same(scalar.life, simd.life, n))
+            return false;
+    }
+    return true;
+}
+
+const char* particleSimdName() {
+#if defined(PARTICLES_AVX2)
+    return "AVX2";
+#elif defined(PARTICLES_SSE)
+    return "SSE2";
+#elif defined(PARTICLES_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
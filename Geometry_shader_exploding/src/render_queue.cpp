@@ -0,0 +1,105 @@
+#include <learnopengl/render_queue.h>
+
+#include <algorithm>
+#include <utility>
+
+static const unsigned int PROGRAM_BITS = 10, VERTEX_ARRAY_BITS = 12, MATERIAL_BITS = 12;
+static const unsigned int STATE_BITS = PROGRAM_BITS + VERTEX_ARRAY_BITS + MATERIAL_BITS;
+
+static std::uint64_t low(unsigned int value, unsigned int bits) {
+    return value & ((1ull << bits) - 1);
+}
+
+std::uint64_t makeSortKey(const SortKeyFields& f) {
+    const std::uint64_t depthMax = (1ull << SORT_KEY_DEPTH_BITS) - 1;
+    std::uint64_t depth = (std::uint64_t)(std::min(std::max(f.depth, 0.0f), 1.0f) * depthMax);
+    std::uint64_t state = low(f.program, PROGRAM_BITS) << (VERTEX_ARRAY_BITS + MATERIAL_BITS)
+        | low(f.vertexArray, VERTEX_ARRAY_BITS) << MATERIAL_BITS
+        | low(f.material, MATERIAL_BITS);
+
+    std::uint64_t key = low(f.pass, 4) << 59 | (std::uint64_t)(f.transparent ? 1 : 0) << 58;
+    if (f.transparent)
+        key |= (depthMax - depth) << STATE_BITS | state;
+    else
+        key |= state << SORT_KEY_DEPTH_BITS | depth;
+    return key;
+}
+
+// the state bits of a key, wherever the layout put them
+static std::uint64_t stateOf(std::uint64_t key) {
+    const std::uint64_t stateMask = (1ull << STATE_BITS) - 1;
+    bool transparent = (key >> 58 & 1) != 0;
+    return transparent ? key & stateMask : key >> SORT_KEY_DEPTH_BITS & stateMask;
+}
+
+void radixSort(std::vector<SortItem>& items, std::vector<SortItem>& scratch) {
+    const std::size_t n = items.size();
+    if (n < 2)
+        return;
+    scratch.resize(n);
+
+    // all eight histograms in one read
+    std::size_t counts[8][256] = {};
+    for (const SortItem& item : items) {
+        for (int b = 0; b < 8; b++)
+            counts[b][item.key >> (8 * b) & 0xff]++;
+    }
+
+    for (int b = 0; b < 8; b++) {
+        std::size_t* count = counts[b];
+        if (count[items[0].key >> (8 * b) & 0xff] == n)
+            continue;  // every key has the same byte here
+        std::size_t offset = 0;
+        for (int v = 0; v < 256; v++) {
+            std::size_t c = count[v];
+            count[v] = offset;
+            offset += c;
+        }
+        for (const SortItem& item : items)
+            scratch[count[item.key >> (8 * b) & 0xff]++] = item;
+        items.swap(scratch);
+    }
+}
+
+const std::size_t RenderQueue::ARENA_BLOCK_SIZE;
+
+void RenderQueue::clear() {
+    packets.clear();
+    items.clear();
+    block = used = 0;
+}
+
+void* RenderQueue::allocate(std::size_t size, std::size_t alignment) {
+    std::size_t offset = (used + alignment - 1) / alignment * alignment;
+    if (block < blocks.size() && offset + size > ARENA_BLOCK_SIZE) {
+        block++;
+        offset = 0;
+    }
+    if (block == blocks.size()) {
+        const std::size_t words = (ARENA_BLOCK_SIZE + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+        blocks.emplace_back(new std::max_align_t[words]);
+    }
+    used = offset + size;
+    return (unsigned char*)blocks[block].get() + offset;
+}
+
+void RenderQueue::execute() {
+    auto countChanges = [this]() {
+        std::size_t changes = 0;
+        for (std::size_t i = 0; i < items.size(); i++) {
+            if (i == 0 || stateOf(items[i].key) != stateOf(items[i - 1].key))
+                changes++;
+        }
+        return changes;
+    };
+
+    stats_ = RenderQueueStats();
+    stats_.packets = items.size();
+    stats_.unsortedStateChanges = countChanges();
+    radixSort(items, scratch);
+    stats_.stateChanges = countChanges();
+
+    for (const SortItem& item : items)
+        packets[item.index].run(packets[item.index].command);
+    clear();
+}
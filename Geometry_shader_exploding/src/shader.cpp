@@ -1,9 +1,14 @@
 #include <learnopengl/shader.h>
+#include <learnopengl/frame_data.h>
+#include <learnopengl/gl_state.h>
+#include <learnopengl/material.h>
 #include <glad/glad.h>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 
+static std::size_t uniformLocationQueries = 0;
+
 static void checkCompileErrors(unsigned int id, const std::string& type) {
     int success;
     char infoLog[1024];
@@ -54,6 +59,7 @@ Shader::Shader(const char* vPath, const char* fPath) {
     glAttachShader(ID, f);
     glLinkProgram(ID);
     checkCompileErrors(ID, "PROGRAM");
+    reflectUniforms();
 
     glDeleteShader(v);
     glDeleteShader(f);
@@ -87,16 +93,103 @@ Shader::Shader(const char* vPath, const char* fPath, const char* gPath) {
     glAttachShader(ID, f);
     glAttachShader(ID, g);
     glLinkProgram(ID); checkCompileErrors(ID, "PROGRAM");
+    reflectUniforms();
 
     glDeleteShader(v);
     glDeleteShader(f);
     glDeleteShader(g);
 }
 
-void Shader::use() const { glUseProgram(ID); }
-void Shader::setBool(const std::string& n, bool v)   const { glUniform1i(glGetUniformLocation(ID, n.c_str()), (int)v); }
-void Shader::setInt(const std::string& n, int  v)   const { glUniform1i(glGetUniformLocation(ID, n.c_str()), v); }
-void Shader::setFloat(const std::string& n, float v)  const { glUniform1f(glGetUniformLocation(ID, n.c_str()), v); }
-void Shader::setMat4(const std::string& n, const glm::mat4& m) const {
-    glUniformMatrix4fv(glGetUniformLocation(ID, n.c_str()), 1, GL_FALSE, &m[0][0]);
-}
\ No newline at end of file
+// VS + transform feedback
+Shader::Shader(const char* vPath, const char* const* feedbackVaryings, int varyingCount) {
+    std::string vCode;
+    std::ifstream vFile(vPath);
+    std::stringstream vSS;
+    vSS << vFile.rdbuf();
+    vCode = vSS.str();
+    const char* vSrc = vCode.c_str();
+
+    unsigned int v = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(v, 1, &vSrc, NULL);
+    glCompileShader(v); checkCompileErrors(v, "VERTEX");
+
+    ID = glCreateProgram();
+    glAttachShader(ID, v);
+    glTransformFeedbackVaryings(ID, varyingCount, feedbackVaryings, GL_INTERLEAVED_ATTRIBS);
+    glLinkProgram(ID); checkCompileErrors(ID, "PROGRAM");
+    reflectUniforms();
+
+    glDeleteShader(v);
+}
+
+// Every active uniform goes into the table under its hashed name. Arrays are reported as "name[0]";
+// each element is registered as "name[i]" and the first one also as plain "name".
+// texture_<type>N samplers are pointed at their fixed units (see material.h) and a FrameData block,
+// if the program declares one, is bound to FRAME_DATA_BINDING.
+void Shader::reflectUniforms() {
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::string name(maxLength > 0 ? maxLength : 1, '\0');
+
+    glState().useProgram(ID);  // for the sampler units
+
+    auto add = [this](const std::string& uniformName) {
+        GLint location = glGetUniformLocation(ID, uniformName.c_str());
+        uniformLocationQueries++;
+        if (location < 0)
+            return;  // uniform block member, set through its buffer
+        auto inserted = uniforms.emplace(uniformHash(uniformName.c_str()), location);
+        if (!inserted.second && inserted.first->second != location)
+            std::cerr << "ERROR::SHADER::uniform name hash collision on " << uniformName << std::endl;
+        GLuint unit;
+        if (samplerUnit(uniformName, unit))
+            glUniform1i(location, (GLint)unit);
+    };
+
+    for (GLint i = 0; i < count; i++) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, (GLuint)i, (GLsizei)name.size(), &length, &size, &type, &name[0]);
+        std::string uniformName(name.data(), length);
+        std::string::size_type bracket = uniformName.find('[');
+        if (bracket == std::string::npos) {
+            add(uniformName);
+            continue;
+        }
+        std::string base = uniformName.substr(0, bracket);
+        add(base);
+        for (GLint element = 0; element < size; element++)
+            add(base + "[" + std::to_string(element) + "]");
+    }
+
+    GLuint frameData = glGetUniformBlockIndex(ID, FRAME_DATA_BLOCK);
+    if (frameData != GL_INVALID_INDEX)
+        glUniformBlockBinding(ID, frameData, FRAME_DATA_BINDING);
+}
+
+std::size_t Shader::locationQueries() { return uniformLocationQueries; }
+
+UniformHandle Shader::uniform(UniformName name) const {
+    UniformHandle handle;
+    auto found = uniforms.find(name.hash);
+    if (found != uniforms.end())
+        handle.location = found->second;
+    return handle;
+}
+
+void Shader::use() const { glState().useProgram(ID); }
+void Shader::setBool(UniformName n, bool v)   const { setBool(uniform(n), v); }
+void Shader::setInt(UniformName n, int  v)   const { setInt(uniform(n), v); }
+void Shader::setFloat(UniformName n, float v)  const { setFloat(uniform(n), v); }
+void Shader::setVec3(UniformName n, const glm::vec3& v) const { setVec3(uniform(n), v); }
+void Shader::setMat4(UniformName n, const glm::mat4& m) const { setMat4(uniform(n), m); }
+
+void Shader::setBool(UniformHandle u, bool v)   const { glUniform1i(u.location, (int)v); }
+void Shader::setInt(UniformHandle u, int  v)   const { glUniform1i(u.location, v); }
+void Shader::setFloat(UniformHandle u, float v)  const { glUniform1f(u.location, v); }
+void Shader::setVec3(UniformHandle u, const glm::vec3& v) const { glUniform3fv(u.location, 1, &v[0]); }
+void Shader::setMat4(UniformHandle u, const glm::mat4& m) const {
+    glUniformMatrix4fv(u.location, 1, GL_FALSE, &m[0][0]);
+}
@@ -0,0 +1,110 @@
+#include <learnopengl/stream_buffer.h>
+#include <learnopengl/gl_state.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// ARB_buffer_storage is not part of the 3.3 core loader
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT   0x0080
+typedef void (APIENTRYP PFNGLBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+static PFNGLBUFFERSTORAGEPROC bufferStorage = nullptr;
+
+bool loadBufferStorage(GLADloadproc load) {
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; i++) {
+        const char* name = (const char*)glGetStringi(GL_EXTENSIONS, i);
+        if (name && std::strcmp(name, "GL_ARB_buffer_storage") == 0) {
+            bufferStorage = (PFNGLBUFFERSTORAGEPROC)load("glBufferStorage");
+            break;
+        }
+    }
+    return bufferStorage != nullptr;
+}
+
+StreamBuffer::StreamBuffer(GLsizeiptr frameSize, int frames)
+    : frameSize(frameSize), frames(std::min(std::max(frames, 1), 8))
+{
+    GLsizeiptr total = frameSize * this->frames;
+    glGenBuffers(1, &id);
+    // GL_COPY_WRITE_BUFFER keeps the VAO / element bindings of the caller untouched
+    glState().bindBuffer(GL_COPY_WRITE_BUFFER, id);
+    if (bufferStorage) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        bufferStorage(GL_COPY_WRITE_BUFFER, total, nullptr, flags);
+        mapped = (char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, total, flags);
+    }
+    else {
+        glBufferData(GL_COPY_WRITE_BUFFER, total, nullptr, GL_STREAM_DRAW);
+    }
+    glState().bindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+StreamBuffer::~StreamBuffer() {
+    for (GLsync& fence : fences)
+        if (fence) glDeleteSync(fence);
+    if (mapped) {
+        glState().bindBuffer(GL_COPY_WRITE_BUFFER, id);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    }
+    glState().forgetBuffer(id);
+    glDeleteBuffers(1, &id);
+}
+
+void StreamBuffer::beginFrame() {
+    region = (region + 1) % frames;
+    head = 0;
+
+    GLsync& fence = fences[region];
+    if (!fence)
+        return;
+    GLenum status = glClientWaitSync(fence, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        stallCount++;
+        do {
+            status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);  // 1 ms
+        } while (status == GL_TIMEOUT_EXPIRED);
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void StreamBuffer::endFrame() {
+    fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+StreamAllocation StreamBuffer::allocate(GLsizeiptr size, GLsizeiptr alignment) {
+    StreamAllocation a;
+    if (size <= 0)
+        return a;
+    GLintptr base = (GLintptr)region * frameSize;
+    GLintptr offset = (base + head + alignment - 1) / alignment * alignment;
+    if (offset + size > base + frameSize) {
+        std::cerr << "StreamBuffer: frame region exhausted (" << size << " bytes requested)" << std::endl;
+        return a;
+    }
+    head = offset + size - base;
+
+    a.buffer = id;
+    a.offset = offset;
+    a.size = size;
+    if (mapped) {
+        a.ptr = mapped + offset;
+    }
+    else {
+        // the fence already guarantees the GPU is done with this range
+        glState().bindBuffer(GL_COPY_WRITE_BUFFER, id);
+        a.ptr = glMapBufferRange(GL_COPY_WRITE_BUFFER, offset, size,
+            GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+    }
+    return a;
+}
+
+void StreamBuffer::commit(const StreamAllocation& allocation) {
+    if (mapped || !allocation.ptr)
+        return;
+    glState().bindBuffer(GL_COPY_WRITE_BUFFER, id);
+    glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+}
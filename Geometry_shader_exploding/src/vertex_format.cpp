@@ -0,0 +1,173 @@
+#include <learnopengl/vertex_format.h>
+#include <learnopengl/mesh.h>
+
+#include <glm/gtc/packing.hpp>
+
+#include <cstdint>
+#include <cstring>
+
+VertexFormat VertexFormat::consumedBy(std::initializer_list<const Shader*> programs, bool quantize) {
+    VertexFormat format;
+    format.attributes = VERTEX_POSITION;
+    format.quantize = quantize;
+    for (const Shader* program : programs) {
+        GLint count = 0;
+        glGetProgramiv(program->ID, GL_ACTIVE_ATTRIBUTES, &count);
+        for (GLint i = 0; i < count; i++) {
+            char name[256];
+            GLint size;
+            GLenum type;
+            glGetActiveAttrib(program->ID, (GLuint)i, sizeof(name), NULL, &size, &type, name);
+            GLint location = glGetAttribLocation(program->ID, name);
+            if (location >= 0 && location <= 4)
+                format.attributes |= 1u << location;
+            else if (location == 5 || location == 6)
+                format.attributes |= VERTEX_BONES;
+        }
+    }
+    return format;
+}
+
+VertexLayout makeVertexLayout(const VertexFormat& format, unsigned int available,
+                              const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+    VertexLayout layout;
+    layout.attributes = (format.attributes & available) | VERTEX_POSITION;
+    layout.quantized = format.quantize;
+    if (layout.isFullVertex()) {
+        layout.stride = sizeof(Vertex);
+        layout.offsets[0] = offsetof(Vertex, Position);
+        layout.offsets[1] = offsetof(Vertex, Normal);
+        layout.offsets[2] = offsetof(Vertex, TexCoords);
+        layout.offsets[3] = offsetof(Vertex, Tangent);
+        layout.offsets[4] = offsetof(Vertex, Bitangent);
+        layout.offsets[5] = offsetof(Vertex, m_BoneIDs);
+        layout.offsets[6] = offsetof(Vertex, m_Weights);
+        return layout;
+    }
+
+    // bytes per attribute location, every size is a multiple of 4
+    const unsigned int floatSizes[7] = { 12, 12, 8, 12, 12, 16, 16 };
+    const unsigned int quantSizes[7] = { 8, 4, 4, 4, 4, 8, 4 };
+    unsigned int offset = 0;
+    for (int loc = 0; loc < 7; loc++) {
+        unsigned int bit = loc < 5 ? 1u << loc : VERTEX_BONES;
+        if (!(layout.attributes & bit))
+            continue;
+        layout.offsets[loc] = offset;
+        offset += layout.quantized ? quantSizes[loc] : floatSizes[loc];
+    }
+    layout.stride = offset;
+
+    if (layout.quantized) {
+        glm::vec3 extent = boundsMax - boundsMin;
+        layout.positionOffset = boundsMin;
+        layout.positionScale = glm::vec3(
+            extent.x > 0.0f ? extent.x : 1.0f,
+            extent.y > 0.0f ? extent.y : 1.0f,
+            extent.z > 0.0f ? extent.z : 1.0f);
+    }
+    return layout;
+}
+
+static std::uint32_t packDirection(const glm::vec3& v) {
+    return glm::packSnorm3x10_1x2(glm::vec4(glm::clamp(v, -1.0f, 1.0f), 0.0f));
+}
+
+void packVertices(const VertexLayout& layout, const Vertex* vertices, std::size_t count, std::vector<unsigned char>& out) {
+    out.resize(count * layout.stride);
+    const glm::vec3 invScale = 1.0f / layout.positionScale;
+    for (std::size_t i = 0; i < count; i++) {
+        const Vertex& v = vertices[i];
+        unsigned char* dst = out.data() + i * layout.stride;
+        auto put = [&](int loc, const void* data, std::size_t size) { std::memcpy(dst + layout.offsets[loc], data, size); };
+
+        if (!layout.quantized) {
+            put(0, &v.Position, 12);
+            if (layout.attributes & VERTEX_NORMAL)    put(1, &v.Normal, 12);
+            if (layout.attributes & VERTEX_TEXCOORDS) put(2, &v.TexCoords, 8);
+            if (layout.attributes & VERTEX_TANGENT)   put(3, &v.Tangent, 12);
+            if (layout.attributes & VERTEX_BITANGENT) put(4, &v.Bitangent, 12);
+            if (layout.attributes & VERTEX_BONES) {
+                put(5, v.m_BoneIDs, 16);
+                put(6, v.m_Weights, 16);
+            }
+            continue;
+        }
+
+        glm::vec3 p = (v.Position - layout.positionOffset) * invScale;
+        std::uint16_t pos[4] = { glm::packUnorm1x16(p.x), glm::packUnorm1x16(p.y), glm::packUnorm1x16(p.z), 0 };
+        put(0, pos, 8);
+        if (layout.attributes & VERTEX_NORMAL) {
+            std::uint32_t n = packDirection(v.Normal);
+            put(1, &n, 4);
+        }
+        if (layout.attributes & VERTEX_TEXCOORDS) {
+            std::uint16_t uv[2] = { glm::packHalf1x16(v.TexCoords.x), glm::packHalf1x16(v.TexCoords.y) };
+            put(2, uv, 4);
+        }
+        if (layout.attributes & VERTEX_TANGENT) {
+            std::uint32_t t = packDirection(v.Tangent);
+            put(3, &t, 4);
+        }
+        if (layout.attributes & VERTEX_BITANGENT) {
+            std::uint32_t b = packDirection(v.Bitangent);
+            put(4, &b, 4);
+        }
+        if (layout.attributes & VERTEX_BONES) {
+            std::uint16_t ids[4];
+            std::uint8_t weights[4];
+            for (int k = 0; k < 4; k++) {
+                ids[k] = (std::uint16_t)v.m_BoneIDs[k];
+                weights[k] = glm::packUnorm1x8(v.m_Weights[k]);
+            }
+            put(5, ids, 8);
+            put(6, weights, 4);
+        }
+    }
+}
+
+void setVertexAttributes(const VertexLayout& layout, std::size_t baseOffset) {
+    auto offset = [&](int loc) { return (void*)(baseOffset + layout.offsets[loc]); };
+    GLsizei stride = (GLsizei)layout.stride;
+    bool q = layout.quantized;
+
+    glEnableVertexAttribArray(0);
+    if (q) glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, stride, offset(0));
+    else   glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, offset(0));
+
+    for (int loc : { 1, 3, 4 }) {
+        if (!(layout.attributes & (1u << loc))) {
+            glDisableVertexAttribArray(loc);
+            continue;
+        }
+        glEnableVertexAttribArray(loc);
+        if (q) glVertexAttribPointer(loc, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, offset(loc));
+        else   glVertexAttribPointer(loc, 3, GL_FLOAT, GL_FALSE, stride, offset(loc));
+    }
+
+    if (layout.attributes & VERTEX_TEXCOORDS) {
+        glEnableVertexAttribArray(2);
+        if (q) glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, offset(2));
+        else   glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, offset(2));
+    }
+    else {
+        glDisableVertexAttribArray(2);
+    }
+
+    if (layout.attributes & VERTEX_BONES) {
+        glEnableVertexAttribArray(5);
+        glEnableVertexAttribArray(6);
+        if (q) {
+            glVertexAttribIPointer(5, 4, GL_UNSIGNED_SHORT, stride, offset(5));
+            glVertexAttribPointer(6, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, offset(6));
+        }
+        else {
+            glVertexAttribIPointer(5, 4, GL_INT, stride, offset(5));
+            glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, stride, offset(6));
+        }
+    }
+    else {
+        glDisableVertexAttribArray(5);
+        glDisableVertexAttribArray(6);
+    }
+}